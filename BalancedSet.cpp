@@ -1,14 +1,17 @@
 #include "BalancedSet.h"
 #include <iostream>
 
-BalancedSet::BalancedSet()
+template <int N>
+BasicBalancedSet<N>::BasicBalancedSet()
+    : complementMap(CubeTraits<N>::kValues, 0)
 {
-    for (int i = 0; i < 256; ++i) {
-        if (countSetBits(static_cast<uint8_t>(i)) == 4) {
-            uint8_t val = static_cast<uint8_t>(i);
+    const uint32_t topBit = 1u << (N - 1);
+    for (uint32_t i = 0; i < CubeTraits<N>::kValues; ++i) {
+        if (countSetBits(i) == CubeTraits<N>::kHalf) {
+            Row val = static_cast<Row>(i);
             allBalanced.push_back(val);
-            if (val >= 128) upSet.push_back(val);
-            complementMap[val] = ~val;
+            if (i >= topBit) upSet.push_back(val);
+            complementMap[val] = static_cast<Row>(~i & CubeTraits<N>::kRowMask);
         }
     }
     std::sort(upSet.rbegin(), upSet.rend());
@@ -17,46 +20,48 @@ BalancedSet::BalancedSet()
     generateShiftSets();
 }
 
-int BalancedSet::countSetBits(uint8_t n) const
+template <int N>
+int BasicBalancedSet<N>::countSetBits(uint32_t n) const
 {
     int count = 0;
     while (n > 0) { n &= (n - 1); count++; }
     return count;
 }
 
-uint8_t BalancedSet::getComplement(uint8_t val) const
+template <int N>
+typename BasicBalancedSet<N>::Row BasicBalancedSet<N>::getComplement(Row val) const
 {
     return complementMap[val];
 }
 
-bool BalancedSet::isBalanced(uint8_t val) const
+template <int N>
+bool BasicBalancedSet<N>::isBalanced(Row val) const
 {
-    int count = 0;
-    uint8_t temp = val;
-    while (temp > 0) { temp &= (temp - 1); count++; }
-    return count == 4;
+    return countSetBits(val) == CubeTraits<N>::kHalf;
 }
 
-uint8_t BalancedSet::rotateLeft(uint8_t val) const
+template <int N>
+typename BasicBalancedSet<N>::Row BasicBalancedSet<N>::rotateLeft(Row val) const
 {
     // Rotate left by 1 bit with wrap-around
-    return static_cast<uint8_t>((val << 1) | (val >> 7));
+    return static_cast<Row>(((val << 1) | (val >> (N - 1))) & CubeTraits<N>::kRowMask);
 }
 
-bool BalancedSet::isValidShiftSet(uint8_t base) const
+template <int N>
+bool BasicBalancedSet<N>::isValidShiftSet(Row base) const
 {
-    // Check if 8 left rotations produce all unique balanced numbers
-    std::array<uint8_t, 8> rotations;
-    uint8_t current = base;
+    // Check if N left rotations produce all unique balanced numbers
+    std::array<Row, N> rotations;
+    Row current = base;
     
-    for (int i = 0; i < 8; ++i) {
+    for (int i = 0; i < N; ++i) {
         rotations[i] = current;
         current = rotateLeft(current);
     }
     
     // Check uniqueness - all must be different
-    for (int i = 0; i < 8; ++i) {
-        for (int j = i + 1; j < 8; ++j) {
+    for (int i = 0; i < N; ++i) {
+        for (int j = i + 1; j < N; ++j) {
             if (rotations[i] == rotations[j]) return false;
         }
     }
@@ -64,17 +69,18 @@ bool BalancedSet::isValidShiftSet(uint8_t base) const
     return true;
 }
 
-void BalancedSet::generateShiftSets()
+template <int N>
+void BasicBalancedSet<N>::generateShiftSets()
 {
     std::cout << "[BalancedSet] Generating shift sets..." << std::endl;
     
-    for (uint8_t balanced : allBalanced) {
+    for (Row balanced : allBalanced) {
         if (isValidShiftSet(balanced)) {
-            ShiftSet ss;
+            ShiftSetType ss;
             ss.base = balanced;
-            uint8_t current = balanced;
+            Row current = balanced;
             
-            for (int i = 0; i < 8; ++i) {
+            for (int i = 0; i < N; ++i) {
                 ss.values[i] = current;
                 current = rotateLeft(current);
             }
@@ -92,35 +98,45 @@ void BalancedSet::generateShiftSets()
     std::cout << "[BalancedSet] Filtered to " << filteredShiftSets.size() << " passing filter rule" << std::endl;
 }
 
-bool BalancedSet::passesFilterRule(const std::array<uint8_t, 8>& values) const
+template <int N>
+bool BasicBalancedSet<N>::passesFilterRule(const std::array<Row, N>& values) const
 {
-    // Rule 1: 4 values >= 128, 4 values < 128
+    const uint32_t topBit = 1u << (N - 1);
+    
+    // Rule 1: N/2 values in the upper half, N/2 in the lower half
     int upperCount = 0;
-    for (uint8_t val : values) {
-        if (val >= 128) upperCount++;
+    for (Row val : values) {
+        if (val >= topBit) upperCount++;
     }
-    if (upperCount != 4) return false;
+    if (upperCount != N / 2) return false;
+    
+    // Rules 2 and 3 split each half evenly by parity, which needs an even half
+    if ((N / 2) % 2 != 0) return true;
     
-    // Rule 2: Upper group (>=128): 2 even + 2 odd
+    // Rule 2: Upper group: N/4 even + N/4 odd
     int upperEven = 0, upperOdd = 0;
-    for (uint8_t val : values) {
-        if (val >= 128) {
+    for (Row val : values) {
+        if (val >= topBit) {
             if (val % 2 == 0) upperEven++;
             else upperOdd++;
         }
     }
-    if (upperEven != 2 || upperOdd != 2) return false;
+    if (upperEven != N / 4 || upperOdd != N / 4) return false;
     
-    // Rule 3: Lower group (<128): 2 even + 2 odd
+    // Rule 3: Lower group: N/4 even + N/4 odd
     int lowerEven = 0, lowerOdd = 0;
-    for (uint8_t val : values) {
-        if (val < 128) {
+    for (Row val : values) {
+        if (val < topBit) {
             if (val % 2 == 0) lowerEven++;
             else lowerOdd++;
         }
     }
-    if (lowerEven != 2 || lowerOdd != 2) return false;
+    if (lowerEven != N / 4 || lowerOdd != N / 4) return false;
     
     return true;
 }
 
+template class BasicBalancedSet<4>;
+template class BasicBalancedSet<6>;
+template class BasicBalancedSet<8>;
+template class BasicBalancedSet<16>;
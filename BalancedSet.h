@@ -1,51 +1,69 @@
 #ifndef BALANCEDSET_H
 #define BALANCEDSET_H
 
+#include "CubeTraits.h"
 #include <vector>
 #include <cstdint>
 #include <algorithm>
 #include <array>
 
-// Shift rotation set: 8 unique balanced numbers (each shifted by 1 bit)
-struct ShiftSet {
-    std::array<uint8_t, 8> values;
-    uint8_t base;  // Original number before shift
+// Shift rotation set: N unique balanced numbers (each shifted by 1 bit)
+template <int N>
+struct BasicShiftSet {
+    using Row = typename CubeTraits<N>::Row;
     
-    ShiftSet() : base(0) {
-        for (int i = 0; i < 8; ++i) values[i] = 0;
+    std::array<Row, N> values;
+    Row base;  // Original number before shift
+    
+    BasicShiftSet() : base(0) {
+        for (int i = 0; i < N; ++i) values[i] = 0;
     }
 };
 
-class BalancedSet {
+// Balanced N-bit numbers (N/2 ones) and their shift sets. Instantiated for
+// N = 4, 6, 8 and 16 in BalancedSet.cpp; the production engines use N = 8.
+template <int N>
+class BasicBalancedSet {
 public:
-    BalancedSet();
+    using Row = typename CubeTraits<N>::Row;
+    using ShiftSetType = BasicShiftSet<N>;
+    
+    BasicBalancedSet();
     
-    const std::vector<uint8_t>& getUpSet() const { return upSet; }
-    const std::vector<uint8_t>& getAllBalanced() const { return allBalanced; }
-    const std::vector<ShiftSet>& getShiftSets() const { return shiftSets; }
+    const std::vector<Row>& getUpSet() const { return upSet; }
+    const std::vector<Row>& getAllBalanced() const { return allBalanced; }
+    const std::vector<ShiftSetType>& getShiftSets() const { return shiftSets; }
     
-    uint8_t getComplement(uint8_t val) const;
-    bool isBalanced(uint8_t val) const;
+    Row getComplement(Row val) const;
+    bool isBalanced(Row val) const;
     
     // New method: rotate left by 1 bit
-    uint8_t rotateLeft(uint8_t val) const;
+    Row rotateLeft(Row val) const;
     
-    // Check if 8 rotations are all unique
-    bool isValidShiftSet(uint8_t base) const;
+    // Check if N rotations are all unique
+    bool isValidShiftSet(Row base) const;
 
 private:
-    std::vector<uint8_t> allBalanced;
-    std::vector<uint8_t> upSet;
-    std::vector<ShiftSet> shiftSets;  // Valid shift sets
-    std::vector<ShiftSet> filteredShiftSets;  // Sets that pass filter rule
-    uint8_t complementMap[256];
+    std::vector<Row> allBalanced;
+    std::vector<Row> upSet;
+    std::vector<ShiftSetType> shiftSets;  // Valid shift sets
+    std::vector<ShiftSetType> filteredShiftSets;  // Sets that pass filter rule
+    std::vector<Row> complementMap;
     
-    int countSetBits(uint8_t n) const;
+    int countSetBits(uint32_t n) const;
     void generateShiftSets();
-    bool passesFilterRule(const std::array<uint8_t, 8>& values) const;
+    bool passesFilterRule(const std::array<Row, N>& values) const;
 
 public:
-    const std::vector<ShiftSet>& getFilteredShiftSets() const { return filteredShiftSets; }
+    const std::vector<ShiftSetType>& getFilteredShiftSets() const { return filteredShiftSets; }
 };
 
+using ShiftSet = BasicShiftSet<8>;
+using BalancedSet = BasicBalancedSet<8>;
+
+extern template class BasicBalancedSet<4>;
+extern template class BasicBalancedSet<6>;
+extern template class BasicBalancedSet<8>;
+extern template class BasicBalancedSet<16>;
+
 #endif
@@ -0,0 +1,441 @@
+// perfect_bit_cube_bench: timings of the hot kernels and of fixed subtrees of
+// both engines, printed as JSON so runs can be compared before deploying.
+//
+//   perfect_bit_cube_bench [--repetitions N] [--warmup N] [--min-time ms]
+//                          [--filter text] [--output file.json]
+//
+// Every benchmark is calibrated first (iterations doubled until one repetition
+// takes at least --min-time), then run --warmup times untimed and
+// --repetitions times timed. Results are nanoseconds per operation.
+#include "BalancedSet.h"
+#include "CandidateFilter.h"
+#include "CubeAssembler.h"
+#include "CubeSearcherV2.h"
+#include "CubeVerifier.h"
+#include "LayerCompatibility.h"
+#include "LayerGenerator.h"
+#include "LayerIndex.h"
+#include "LayerStore.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Reaches the private kernels of the engines (declared a friend by each class)
+struct BenchAccess {
+    static bool validateZAxis(const CubeSearcherV2& searcher, const std::array<ShiftSet, 8>& cube)
+    {
+        return searcher.validateZAxis(cube);
+    }
+
+    // Try every upSet value as row rowIdx after the given rows; returns the number of calls
+    static uint64_t canAddRowSweep(const LayerGenerator& generator, const uint8_t* prefix, int rowIdx,
+                                   uint64_t& accepted)
+    {
+        LayerGenerator::GenState state;
+        for (int r = 0; r < rowIdx; ++r) {
+            LayerGenerator::updateCounts(state, prefix[r], 1);
+        }
+        const auto& upSet = generator.balancedSet.getUpSet();
+        for (uint8_t row : upSet) {
+            accepted += generator.canAddRow(state, row, rowIdx);
+        }
+        return upSet.size();
+    }
+
+    // Shift engine in combination mode with its task list built, ready for runTask
+    static void prepareShiftTasks(CubeSearcherV2& searcher)
+    {
+        searcher.combinations = true;
+        searcher.core.prepare(true, false, CubeSearcherV2::kTaskPrefixDepth);
+        searcher.writer.start(false, ProgressFormat::None);
+    }
+
+    static size_t shiftTaskCount(const CubeSearcherV2& searcher) { return searcher.core.getTaskPrefixes().size(); }
+
+    static uint64_t runShiftTask(CubeSearcherV2& searcher, size_t task)
+    {
+        CubeSearcherV2::TaskContext ctx;
+        searcher.core.runTask(searcher.core.getTaskPrefixes()[task], ctx);
+        return ctx.checked;
+    }
+
+    // Close the searcher's result file and delete it
+    static void discardShiftResults(CubeSearcherV2& searcher)
+    {
+        searcher.writer.close();
+        std::remove(searcher.writer.getTextPath().c_str());
+    }
+
+    static void buildCompatibility(CubeAssembler& assembler, const LayerStore& layers)
+    {
+        assembler.compatibility.build(layers, 1);
+    }
+
+    static void buildPrefixIndex(CubeAssembler& assembler, const LayerStore& layers)
+    {
+        assembler.prefixes.build(layers);
+    }
+
+    static size_t compatibilityWords(const CubeAssembler& assembler)
+    {
+        return assembler.compatibility.wordCount();
+    }
+
+    static void restrict(const CubeAssembler& assembler, const uint8_t rows[8], const uint64_t* in,
+                         uint64_t* out, size_t firstWord)
+    {
+        assembler.compatibility.restrict(rows, in, out, firstWord);
+    }
+
+    // Replace the assembler's leaf: count cubes in cubes instead of queueing them
+    static void countCubes(CubeAssembler& assembler, uint64_t& cubes)
+    {
+        assembler.onCube = [&cubes](const uint8_t[4][8]) {
+            cubes++;
+            return false;
+        };
+    }
+
+    // Complete search over a layer sample small enough to finish: every root
+    // in index or fail-first order, cubes counted
+    static void prepareSample(CubeAssembler& assembler, const LayerStore& layers)
+    {
+        assembler.compatibility.build(layers, 1);
+        assembler.prefixes.build(layers);
+        assembler.buildRootOrder(layers);
+    }
+
+    static uint64_t runSample(CubeAssembler& assembler, const LayerStore& layers, const LayerIndex& index,
+                              bool failFirst)
+    {
+        std::vector<uint64_t> scratch(3 * assembler.compatibility.wordCount());
+        long checked = 0;
+        SearchProfile profile;
+        uint64_t cubes = 0;
+        countCubes(assembler, cubes);
+        const int nRoots = failFirst ? (int)assembler.rootOrder.size() : (int)layers.size();
+        for (int i = 0; i < nRoots; ++i) {
+            assembler.searchRoot(layers, index, i, failFirst, scratch.data(), checked, profile);
+        }
+        return cubes;
+    }
+
+    // The Z=3 level below the fixed prefix: trie walk and candidate filter over
+    // every later layer, each survivor a cube (counted, not queued)
+    static uint64_t runLayerSubtree(CubeAssembler& assembler, const LayerStore& layers, const LayerIndex& index,
+                                    const size_t prefix[3], uint64_t* allowed)
+    {
+        uint8_t rows[4][8];
+        for (int z = 0; z < 3; z++) std::memcpy(rows[z], layers.rows(prefix[z]), 8);
+        long checked = 0;
+        SearchProfile profile;
+        uint64_t cubes = 0;
+        countCubes(assembler, cubes);
+        assembler.searchWithLookup(layers, index, (int)prefix[2] + 1, 3, rows, allowed, checked, profile);
+        return cubes;
+    }
+};
+
+namespace {
+
+// Layer sample for the complete-search benchmarks (200 of 1,256,640 layers)
+constexpr size_t kSampleStride = 6283;
+
+struct BenchConfig {
+    int repetitions = 10;
+    int warmup = 2;
+    double minRepMs = 20.0;
+    std::string filter;
+};
+
+struct BenchResult {
+    std::string name;
+    std::string description;
+    uint64_t iterations = 0;          // Calls of the body per repetition
+    uint64_t opsPerRepetition = 0;    // Operations those calls reported
+    std::vector<double> samples;      // ns per operation, one per repetition
+};
+
+// Keeps benchmark results observable so the optimizer cannot drop the work
+volatile uint64_t sink = 0;
+
+class BenchRunner {
+public:
+    explicit BenchRunner(const BenchConfig& cfg) : config(cfg) {}
+
+    // body() does one unit of work and returns how many operations it performed
+    void run(const std::string& name, const std::string& description, const std::function<uint64_t()>& body)
+    {
+        if (!config.filter.empty() && name.find(config.filter) == std::string::npos) return;
+        std::cerr << "[bench] " << name << std::flush;
+
+        // Calibrate: double the iteration count until a repetition is long enough
+        uint64_t iterations = 1;
+        for (;;) {
+            auto start = Clock::now();
+            uint64_t ops = 0;
+            for (uint64_t i = 0; i < iterations; ++i) ops += body();
+            sink = sink + ops;
+            double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            if (ms >= config.minRepMs || iterations >= (1ULL << 40)) break;
+            iterations *= 2;
+        }
+
+        BenchResult result;
+        result.name = name;
+        result.description = description;
+        result.iterations = iterations;
+        for (int rep = -config.warmup; rep < config.repetitions; ++rep) {
+            auto start = Clock::now();
+            uint64_t ops = 0;
+            for (uint64_t i = 0; i < iterations; ++i) ops += body();
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            sink = sink + ops;
+            if (rep < 0) continue;
+            result.opsPerRepetition = ops;
+            result.samples.push_back(ns / std::max<uint64_t>(1, ops));
+        }
+        std::cerr << " done" << std::endl;
+        results.push_back(result);
+    }
+
+    void writeJson(std::ostream& out) const
+    {
+        out << "{\n";
+        out << "  \"suite\": \"perfect_bit_cube_bench\",\n";
+        out << "  \"schema\": 1,\n";
+        out << "  \"warmup\": " << config.warmup << ",\n";
+        out << "  \"repetitions\": " << config.repetitions << ",\n";
+        out << "  \"min_repetition_ms\": " << config.minRepMs << ",\n";
+        out << "  \"candidate_filter\": \"" << CandidateFilter::kernelName() << "\",\n";
+        out << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+        out << "  \"results\": [";
+        for (size_t r = 0; r < results.size(); ++r) {
+            const BenchResult& res = results[r];
+            std::vector<double> sorted = res.samples;
+            std::sort(sorted.begin(), sorted.end());
+            double mean = 0;
+            for (double s : sorted) mean += s;
+            mean /= sorted.size();
+            double variance = 0;
+            for (double s : sorted) variance += (s - mean) * (s - mean);
+            variance = sorted.size() > 1 ? variance / (sorted.size() - 1) : 0;
+            size_t mid = sorted.size() / 2;
+            double median = sorted.size() % 2 ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2;
+
+            out << (r ? "," : "") << "\n    {\n";
+            out << "      \"name\": \"" << res.name << "\",\n";
+            out << "      \"description\": \"" << res.description << "\",\n";
+            out << "      \"unit\": \"ns/op\",\n";
+            out << "      \"iterations\": " << res.iterations << ",\n";
+            out << "      \"ops_per_repetition\": " << res.opsPerRepetition << ",\n";
+            out << "      \"mean\": " << mean << ",\n";
+            out << "      \"median\": " << median << ",\n";
+            out << "      \"min\": " << sorted.front() << ",\n";
+            out << "      \"max\": " << sorted.back() << ",\n";
+            out << "      \"variance\": " << variance << ",\n";
+            out << "      \"stddev\": " << std::sqrt(variance) << ",\n";
+            out << "      \"ops_per_second\": " << (mean > 0 ? 1e9 / mean : 0) << ",\n";
+            out << "      \"samples\": [";
+            for (size_t s = 0; s < res.samples.size(); ++s) {
+                out << (s ? ", " : "") << res.samples[s];
+            }
+            out << "]\n    }";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    BenchConfig config;
+    std::vector<BenchResult> results;
+};
+
+// Swallows the engines' console output so stdout carries only the JSON
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+bool parseInt(const char* text, int& value)
+{
+    char extra;
+    return std::sscanf(text, "%d%c", &value, &extra) == 1;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    BenchConfig config;
+    std::string outputPath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        int value = 0;
+        if (arg == "--repetitions" && hasValue && parseInt(argv[i + 1], value) && value > 0) {
+            config.repetitions = value;
+            ++i;
+        } else if (arg == "--warmup" && hasValue && parseInt(argv[i + 1], value) && value >= 0) {
+            config.warmup = value;
+            ++i;
+        } else if (arg == "--min-time" && hasValue && parseInt(argv[i + 1], value) && value > 0) {
+            config.minRepMs = value;
+            ++i;
+        } else if (arg == "--filter" && hasValue) {
+            config.filter = argv[++i];
+        } else if (arg == "--output" && hasValue) {
+            outputPath = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--repetitions N] [--warmup N] [--min-time ms]"
+                      << " [--filter text] [--output file.json]" << std::endl;
+            return 1;
+        }
+    }
+
+    NullBuffer nullBuffer;
+    std::streambuf* consoleBuffer = std::cout.rdbuf(&nullBuffer);
+    BenchRunner runner(config);
+    std::mt19937_64 rng(42);
+
+    // --- Shared inputs -----------------------------------------------------
+    BalancedSet bSet;
+    const auto& shiftSets = bSet.getFilteredShiftSets();
+
+    std::cerr << "[bench] Generating layers..." << std::endl;
+    LayerGenerator generator(bSet);
+    SearchOptions generatorOptions;
+    generatorOptions.nThreads = 1;
+    generatorOptions.progressFormat = ProgressFormat::None;
+    generator.generate(generatorOptions);
+    LayerStore layers(generator.getValidLayers());
+    LayerIndex index;
+    index.build(layers);
+    CubeAssembler assembler(bSet);
+    BenchAccess::buildCompatibility(assembler, layers);
+    BenchAccess::buildPrefixIndex(assembler, layers);
+    const size_t words = BenchAccess::compatibilityWords(assembler);
+
+    // Fixed layer prefix: layer 0 and the first layers compatible with it
+    std::vector<uint64_t> allowed(2 * words);
+    BenchAccess::restrict(assembler, layers.rows(0), nullptr, allowed.data(), 0);
+    auto nextAllowed = [&](const uint64_t* set, size_t from) {
+        while (from < layers.size() && !((set[from / 64] >> (from % 64)) & 1)) ++from;
+        return from;
+    };
+    size_t prefix[3] = {0, nextAllowed(allowed.data(), 1), 0};
+    BenchAccess::restrict(assembler, layers.rows(prefix[1]), allowed.data(), allowed.data() + words, 0);
+    prefix[2] = nextAllowed(allowed.data() + words, prefix[1] + 1);
+    uint64_t prefixNumbers[4] = {0, 0, 0, 0};
+    for (int w = 0; w < 4; w++) prefixNumbers[w] = layers.numMask(prefix[2], w);
+
+    // --- Micro benchmarks --------------------------------------------------
+    runner.run("balanced_set_construction", "BalancedSet constructor (balanced numbers, shift sets, filter)",
+               [&]() -> uint64_t {
+        BalancedSet set;
+        sink = sink + set.getFilteredShiftSets().size();
+        return 1;
+    });
+
+    CubeSearcherV2 searcher(bSet);
+    std::vector<std::array<ShiftSet, 8>> cubes(1024);
+    for (auto& cube : cubes) {
+        for (auto& layer : cube) layer = shiftSets[rng() % shiftSets.size()];
+    }
+    runner.run("validate_z_axis", "CubeSearcherV2::validateZAxis on random 8-set cubes", [&]() -> uint64_t {
+        uint64_t valid = 0;
+        for (const auto& cube : cubes) valid += BenchAccess::validateZAxis(searcher, cube);
+        sink = sink + valid;
+        return cubes.size();
+    });
+
+    runner.run("cube_verifier", "CubeVerifier::check (all 192 lines) on random 8-set cubes", [&]() -> uint64_t {
+        uint64_t valid = 0;
+        for (const auto& cube : cubes) valid += CubeVerifier::check(cube).perfect();
+        sink = sink + valid;
+        return cubes.size();
+    });
+
+    runner.run("can_add_row", "LayerGenerator::canAddRow for every upSet value as row 2", [&]() -> uint64_t {
+        uint64_t accepted = 0;
+        uint64_t calls = 0;
+        for (size_t i = 0; i < 64; ++i) {
+            calls += BenchAccess::canAddRowSweep(generator, layers.rows(i * 997 % layers.size()), 2, accepted);
+        }
+        sink = sink + accepted;
+        return calls;
+    });
+
+    std::vector<uint32_t> survivors(layers.size());
+    runner.run("candidate_filter", "searchWithLookup inner loop: CandidateFilter over all layers at Z=3",
+               [&]() -> uint64_t {
+        size_t n = CandidateFilter::filter(layers, 0, layers.size(), prefixNumbers, allowed.data() + words,
+                                           survivors.data());
+        sink = sink + n;
+        return layers.size();
+    });
+
+    // --- Macro benchmarks: fixed-prefix subtrees ----------------------------
+    runner.run("layers_subtree", "Layer engine: full Z=3 level below a fixed 3-layer prefix (cubes counted)",
+               [&]() -> uint64_t {
+        sink = sink + BenchAccess::runLayerSubtree(assembler, layers, index, prefix, allowed.data() + words);
+        return 1;
+    });
+
+    // Every kSampleStride-th layer: few enough for a complete search, so both
+    // branching orders are timed on the same, fully known cube set
+    std::vector<Layer> sampleLayers;
+    for (size_t i = 0; i < generator.getValidLayers().size(); i += kSampleStride) {
+        sampleLayers.push_back(generator.getValidLayers()[i]);
+    }
+    LayerStore sample(sampleLayers);
+    LayerIndex sampleIndex;
+    sampleIndex.build(sample);
+    CubeAssembler sampleAssembler(bSet);
+    BenchAccess::prepareSample(sampleAssembler, sample);
+    const uint64_t sampleCubes = BenchAccess::runSample(sampleAssembler, sample, sampleIndex, false);
+    if (BenchAccess::runSample(sampleAssembler, sample, sampleIndex, true) != sampleCubes) {
+        std::cerr << "[bench] WARNING: branching orders disagree on the sample's cube count" << std::endl;
+    }
+    runner.run("layers_sample_index", "Layer engine: complete search of a layer sample, index order (per cube)",
+               [&]() -> uint64_t {
+        return BenchAccess::runSample(sampleAssembler, sample, sampleIndex, false);
+    });
+    runner.run("layers_sample_fail_first", "Layer engine: complete search of a layer sample, fail-first (per cube)",
+               [&]() -> uint64_t {
+        return BenchAccess::runSample(sampleAssembler, sample, sampleIndex, true);
+    });
+
+    BenchAccess::prepareShiftTasks(searcher);
+    const size_t shiftTask = BenchAccess::shiftTaskCount(searcher) / 2;
+    runner.run("shift_subtree", "Shift engine (combinations): one fixed depth-3 task subtree", [&]() -> uint64_t {
+        sink = sink + BenchAccess::runShiftTask(searcher, shiftTask);
+        return 1;
+    });
+    BenchAccess::discardShiftResults(searcher);
+
+    std::cout.rdbuf(consoleBuffer);
+    if (outputPath.empty()) {
+        runner.writeJson(std::cout);
+    } else {
+        std::ofstream out(outputPath);
+        runner.writeJson(out);
+        if (!out) {
+            std::cerr << "ERROR: Cannot write " << outputPath << std::endl;
+            return 1;
+        }
+        std::cerr << "[bench] Results written to " << outputPath << std::endl;
+    }
+    return 0;
+}
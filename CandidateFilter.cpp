@@ -0,0 +1,154 @@
+#include "CandidateFilter.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PBC_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+inline int lowestBit(uint64_t bits)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return (int)index;
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+// Tests the allowed layers of one 64-layer word (layers base .. base + 63)
+// against the number mask; planes are the store's four mask planes
+using WordFn = size_t (*)(const uint64_t* const planes[4], size_t base, uint64_t allowedBits,
+                          const uint64_t numbers[4], uint32_t* out, size_t n);
+
+// Bits of word w that fall inside [begin, end)
+inline uint64_t rangeMask(size_t w, size_t begin, size_t end)
+{
+    uint64_t mask = ~0ULL;
+    if (begin > w * 64) mask &= ~0ULL << (begin - w * 64);
+    if (end < w * 64 + 64) mask &= (1ULL << (end - w * 64)) - 1;
+    return mask;
+}
+
+size_t wordScalar(const uint64_t* const planes[4], size_t base, uint64_t allowedBits,
+                  const uint64_t numbers[4], uint32_t* out, size_t n)
+{
+    while (allowedBits) {
+        size_t i = base + lowestBit(allowedBits);
+        allowedBits &= allowedBits - 1;
+        uint64_t shared = (planes[0][i] & numbers[0]) | (planes[1][i] & numbers[1]) |
+                          (planes[2][i] & numbers[2]) | (planes[3][i] & numbers[3]);
+        // Branch-free append: the slot is always written, the count only moves on a pass
+        out[n] = (uint32_t)i;
+        n += shared == 0;
+    }
+    return n;
+}
+
+#ifdef PBC_X86_DISPATCH
+
+// Append the indices base + bit for every set bit of passMask
+inline size_t emitIndices(unsigned passMask, size_t base, uint32_t* out, size_t n)
+{
+    while (passMask) {
+        out[n++] = (uint32_t)(base + __builtin_ctz(passMask));
+        passMask &= passMask - 1;
+    }
+    return n;
+}
+
+__attribute__((target("avx2")))
+size_t wordAvx2(const uint64_t* const planes[4], size_t base, uint64_t allowedBits,
+                const uint64_t numbers[4], uint32_t* out, size_t n)
+{
+    __m256i mask[4];
+    for (int w = 0; w < 4; ++w) mask[w] = _mm256_set1_epi64x((long long)numbers[w]);
+    const __m256i zero = _mm256_setzero_si256();
+    for (int group = 0; group < 16; ++group) {
+        unsigned allowed = (unsigned)(allowedBits >> (group * 4)) & 0xF;
+        if (!allowed) continue;
+        size_t first = base + group * 4;
+        __m256i shared = zero;
+        for (int w = 0; w < 4; ++w) {
+            __m256i plane = _mm256_loadu_si256((const __m256i*)(planes[w] + first));
+            shared = _mm256_or_si256(shared, _mm256_and_si256(plane, mask[w]));
+        }
+        unsigned pass = (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(shared, zero)));
+        n = emitIndices(pass & allowed, first, out, n);
+    }
+    return n;
+}
+
+__attribute__((target("avx512f")))
+size_t wordAvx512(const uint64_t* const planes[4], size_t base, uint64_t allowedBits,
+                  const uint64_t numbers[4], uint32_t* out, size_t n)
+{
+    __m512i mask[4];
+    for (int w = 0; w < 4; ++w) mask[w] = _mm512_set1_epi64((long long)numbers[w]);
+    for (int group = 0; group < 8; ++group) {
+        __mmask8 pass = (__mmask8)(allowedBits >> (group * 8));
+        if (!pass) continue;
+        size_t first = base + group * 8;
+        // Each plane only tests the lanes that are still passing
+        for (int w = 0; w < 4 && pass; ++w)
+            pass = _mm512_mask_testn_epi64_mask(pass, _mm512_loadu_si512(planes[w] + first), mask[w]);
+        n = emitIndices(pass, first, out, n);
+    }
+    return n;
+}
+
+#endif
+
+struct Kernel {
+    WordFn fn;
+    const char* name;
+};
+
+Kernel selectKernel()
+{
+#ifdef PBC_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return {wordAvx512, "avx512"};
+    if (__builtin_cpu_supports("avx2")) return {wordAvx2, "avx2"};
+#endif
+    return {wordScalar, "scalar"};
+}
+
+const Kernel& kernel()
+{
+    static const Kernel selected = selectKernel();
+    return selected;
+}
+
+}
+
+namespace CandidateFilter {
+
+size_t filter(const LayerStore& layers, size_t begin, size_t end,
+              const uint64_t numbers[4], const uint64_t* allowed, uint32_t* out)
+{
+    // Whole words of disallowed layers are skipped without touching the masks;
+    // LayerStore pads its arrays to whole words, so the kernels never read past them
+    const WordFn fn = kernel().fn;
+    const uint64_t* const planes[4] = {layers.numMaskPlane(0), layers.numMaskPlane(1),
+                                       layers.numMaskPlane(2), layers.numMaskPlane(3)};
+    size_t n = 0;
+    for (size_t w = begin / 64; w * 64 < end; ++w) {
+        uint64_t bits = allowed[w] & rangeMask(w, begin, end);
+        if (bits) n = fn(planes, w * 64, bits, numbers, out, n);
+    }
+    return n;
+}
+
+const char* kernelName()
+{
+    return kernel().name;
+}
+
+}
@@ -0,0 +1,25 @@
+#ifndef CANDIDATEFILTER_H
+#define CANDIDATEFILTER_H
+
+#include "LayerStore.h"
+#include <cstddef>
+#include <cstdint>
+
+// Batch filter for the assembler's levels: of the layers in [begin, end)
+// whose bit is set in allowed (a set from LayerCompatibility), writes the ones
+// that use none of the numbers in the 256-bit mask to out (at most
+// end - begin entries, ascending).
+// The kernel (AVX-512, AVX2 or scalar) is chosen once at run time from the
+// CPU's features, so one binary runs on every host.
+namespace CandidateFilter {
+
+// Survivors: allowed bit set and (numMask & numbers) == 0
+size_t filter(const LayerStore& layers, size_t begin, size_t end,
+              const uint64_t numbers[4], const uint64_t* allowed, uint32_t* out);
+
+// Name of the selected kernel ("avx512", "avx2" or "scalar")
+const char* kernelName();
+
+}
+
+#endif
@@ -0,0 +1,157 @@
+#include "Checkpoint.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char* kCheckpointMagic = "PBC-CHECKPOINT 1";
+
+// Write a sorted list of integers as "a-b" ranges to keep the file small
+void writeRanges(std::ostream& out, const std::vector<long>& values)
+{
+    size_t i = 0;
+    while (i < values.size()) {
+        size_t j = i;
+        while (j + 1 < values.size() && values[j + 1] == values[j] + 1) ++j;
+        out << " " << values[i];
+        if (j > i) out << "-" << values[j];
+        i = j + 1;
+    }
+}
+
+bool readRanges(std::istringstream& in, std::vector<long>& values)
+{
+    std::string token;
+    while (in >> token) {
+        size_t dash = token.find('-');
+        try {
+            long first = std::stol(token.substr(0, dash));
+            long last = (dash == std::string::npos) ? first : std::stol(token.substr(dash + 1));
+            for (long v = first; v <= last; ++v) values.push_back(v);
+        } catch (...) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int Checkpoint::countCompleted() const
+{
+    return (int)std::count(completedTasks.begin(), completedTasks.end(), 1);
+}
+
+bool Checkpoint::save(const std::string& path) const
+{
+    std::ostringstream out;
+    out << kCheckpointMagic << "\n";
+    out << "fingerprint " << fingerprint << "\n";
+    out << "tasks " << completedTasks.size() << "\n";
+    out << "checked " << checkedPaths << "\n";
+    out << "found " << foundCubes << "\n";
+    out << "next-id " << nextCubeId << "\n";
+    for (const std::string& file : resultFiles) {
+        out << "result-file " << file << "\n";
+    }
+    
+    std::vector<long> done;
+    for (size_t i = 0; i < completedTasks.size(); ++i) {
+        if (completedTasks[i]) done.push_back((long)i);
+    }
+    out << "completed";
+    writeRanges(out, done);
+    out << "\n";
+    
+    std::vector<long> ids = cubeIds;
+    std::sort(ids.begin(), ids.end());
+    out << "cube-ids";
+    writeRanges(out, ids);
+    out << "\n";
+    out << "end\n";
+    
+    // Write + fsync a temporary file, then atomically replace the old checkpoint
+    std::string tmpPath = path + ".tmp";
+    std::string data = out.str();
+    FILE* f = std::fopen(tmpPath.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(data.data(), 1, data.size(), f) == data.size();
+    ok = (std::fflush(f) == 0) && ok;
+#ifndef _WIN32
+    ok = (fsync(fileno(f)) == 0) && ok;
+#endif
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+#ifdef _WIN32
+    std::remove(path.c_str());
+#endif
+    return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+bool Checkpoint::load(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        std::cout << "[Checkpoint] ERROR: Cannot open " << path << std::endl;
+        return false;
+    }
+    
+    std::string line;
+    if (!std::getline(in, line) || line != kCheckpointMagic) {
+        std::cout << "[Checkpoint] ERROR: " << path << " is not a checkpoint file" << std::endl;
+        return false;
+    }
+    
+    *this = Checkpoint();
+    bool complete = false;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        std::string key;
+        fields >> key;
+        
+        if (key == "fingerprint") {
+            std::getline(fields >> std::ws, fingerprint);
+        } else if (key == "tasks") {
+            size_t n = 0;
+            fields >> n;
+            completedTasks.assign(n, 0);
+        } else if (key == "checked") {
+            fields >> checkedPaths;
+        } else if (key == "found") {
+            fields >> foundCubes;
+        } else if (key == "next-id") {
+            fields >> nextCubeId;
+        } else if (key == "result-file") {
+            std::string file;
+            std::getline(fields >> std::ws, file);
+            resultFiles.push_back(file);
+        } else if (key == "completed") {
+            std::vector<long> done;
+            if (!readRanges(fields, done)) break;
+            for (long t : done) {
+                if (t < 0 || t >= (long)completedTasks.size()) return false;
+                completedTasks[t] = 1;
+            }
+        } else if (key == "cube-ids") {
+            if (!readRanges(fields, cubeIds)) break;
+        } else if (key == "end") {
+            complete = true;
+            break;
+        }
+    }
+    
+    if (!complete) {
+        std::cout << "[Checkpoint] ERROR: " << path << " is truncated or corrupt" << std::endl;
+        return false;
+    }
+    return true;
+}
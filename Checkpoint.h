@@ -0,0 +1,30 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Resumable snapshot of a CubeSearcherV2 run: which scheduled tasks (prefix
+// subtrees) are finished, the counters they produced and the ids of the cubes
+// they found. Saved as a small text file, written to a temporary file first and
+// renamed over the old checkpoint so a crash never leaves a torn file behind.
+struct Checkpoint {
+    // Identifies the task list (enumeration mode, prefix depth, task count...);
+    // a checkpoint can only be resumed by a run that builds the same list
+    std::string fingerprint;
+    
+    std::vector<uint8_t> completedTasks;  // 1 if task i finished
+    long checkedPaths{0};                 // Paths checked by completed tasks
+    long foundCubes{0};                   // Cubes found by completed tasks
+    long nextCubeId{0};                   // Highest cube id handed out so far
+    std::vector<long> cubeIds;            // Ids of cubes found by completed tasks
+    std::vector<std::string> resultFiles; // Result files written by every run segment
+    
+    int countCompleted() const;
+    
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+};
+
+#endif
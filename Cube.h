@@ -2,11 +2,13 @@
 #define CUBE_H
 
 #include <cstdint>
-#include <vector>
+#include <type_traits>
 
 struct Cube {
     uint8_t data[8][8];
-    std::vector<uint8_t> usedNumbers;
 };
 
+// Copied into result records and thread-local buffers with memcpy
+static_assert(std::is_trivially_copyable<Cube>::value, "Cube must stay trivially copyable");
+
 #endif
@@ -1,308 +1,480 @@
 #include "CubeAssembler.h"
+#include "CandidateFilter.h"
+#include "ProgressReporter.h"
+#include "SearchTimer.h"
+#include "WorkStealingPool.h"
 #include <iostream>
 #include <algorithm>
 #include <iomanip>
-#include <thread>
 #include <chrono>
 #include <cstring>
 
 CubeAssembler::CubeAssembler(const BalancedSet &bSet)
-    : balancedSet(bSet), checkedPaths(0), foundCount(0) {}
+    : balancedSet(bSet), checkedPaths(0), foundCount(0),
+      onCube([this](const uint8_t rows[4][8]) { return recordCube(rows); }) {}
 
-void CubeAssembler::assembleParallel(const std::vector<Layer> &layers, int nThreads)
+void CubeAssembler::assembleParallel(const LayerStore &layers, const LayerIndex &index,
+                                     const SearchOptions &options)
 {
+    const int nThreads = std::max(1, options.nThreads);
+    findOnlyFirst = options.findOnlyFirst;
+    stopSearch = false;
+    interrupted = false;
+    profile = SearchProfile();
+
     int n = layers.size();
     if (n == 0) {
         std::cout << "[CubeAssembler] ERROR: No layers to assemble!" << std::endl;
         return;
     }
 
-    std::cout << "[CubeAssembler] Building lookup index..." << std::endl;
-
-    // Build lookup table by first row value
-    std::vector<std::vector<int>> lookup(256);
-    for (int i = 0; i < n; ++i) {
-        lookup[layers[i].rows[0]].push_back(i);
-    }
-
     // Count non-empty buckets for statistics
     int nonEmptyBuckets = 0;
     for (int i = 0; i < 256; ++i) {
-        if (!lookup[i].empty()) nonEmptyBuckets++;
+        if (!index.withFirstRow((uint8_t)i).empty()) nonEmptyBuckets++;
+    }
+    std::cout << "[CubeAssembler] Lookup ready: " << nonEmptyBuckets << " first-row buckets"
+              << (index.rowSpans().empty() ? " (not id runs: no span pruning)" : " (id runs)") << std::endl;
+    std::cout << "[CubeAssembler] Layer store: " << (layers.footprint() / (1024.0 * 1024.0)) << " MB" << std::endl;
+    std::cout << "[CubeAssembler] Candidate filter: " << CandidateFilter::kernelName() << std::endl;
+
+    // Number-compatibility bitsets (narrowed per depth during the search)
+    compatibility.build(layers, nThreads);
+    std::cout << "[CubeAssembler] Compatibility bitsets: "
+              << (compatibility.footprint() / (1024.0 * 1024.0)) << " MB" << std::endl;
+
+    // Fail-first: the root's branching order instead of the prefix index
+    const bool failFirst = options.branching == Branching::FailFirst;
+    if (!failFirst) {
+        prefixes.build(layers);
+        std::cout << "[CubeAssembler] Prefix index: " << prefixes.nodeCount(0) << " / "
+                  << prefixes.nodeCount(1) << " nodes (2-3 rows), "
+                  << (prefixes.footprint() / (1024.0 * 1024.0)) << " MB" << std::endl;
+    } else {
+        buildRootOrder(layers);
+        std::cout << "[CubeAssembler] Fail-first root branches: " << rootOrder.size() << " over "
+                  << rootChain.size() << " up numbers" << std::endl;
     }
-    std::cout << "[CubeAssembler] Lookup ready: " << nonEmptyBuckets << " buckets with data" << std::endl;
+    const int nRoots = failFirst ? (int)rootOrder.size() : n;
+
+    writer.openTimestamped("[CubeAssembler]");
+    writer.openCompanion(options.outputFormat, "[CubeAssembler]");
+    writer.writeHeader({{"Engine", "layers"},
+                        {"Mode", findOnlyFirst ? "FIND FIRST ONLY" : "FIND ALL"},
+                        {"Enumeration", "LAYERS"},
+                        {"Branching", failFirst ? "FAIL-FIRST" : "INDEX"},
+                        {"Valid layers", std::to_string(n)},
+                        {"Shard", "0/1"}});
+    // Layer find-all runs at millions of cubes per second: announce only the first
+    writer.start(false, options.progressFormat, findOnlyFirst);
 
     std::atomic<int> completedRoots{0};
     auto startTime = std::chrono::steady_clock::now();
-    std::vector<std::thread> threads;
-
-    // Distribute work evenly across threads
-    int chunk = (n + nThreads - 1) / nThreads;
-
-    std::cout << "[CubeAssembler] Launching " << nThreads << " worker threads..." << std::endl;
-    std::cout << "[CubeAssembler] Searching " << n << " root layers (chunk size: " << chunk << ")\n" << std::endl;
-
-    for (int t = 0; t < nThreads; ++t) {
-        threads.emplace_back([this, &layers, &lookup, t, chunk, n, &completedRoots, startTime]() {
-            int start = t * chunk;
-            int end = std::min(start + chunk, n);
 
-            // Thread-local state
-            uint64_t localZCounts[3];
-            uint64_t localMask[4];
-            uint8_t localRows[4][8];
-            long localChecked = 0;
+    // One task per root: the early roots carry most of the tree, so idle
+    // workers steal the roots still queued behind them
+    WorkStealingPool pool(nThreads);
+    std::vector<SearchProfile> workerProfiles(nThreads);
 
-            for (int i = start; i < end; ++i) {
-                const Layer &L1 = layers[i];
+    // Candidate sets for the levels below the root, one block per worker
+    std::vector<std::vector<uint64_t>> workerScratch(nThreads,
+                                                     std::vector<uint64_t>(3 * compatibility.wordCount()));
 
-                // Initialize state with first layer
-                localZCounts[0] = L1.bitMatrix;
-                localZCounts[1] = 0;
-                localZCounts[2] = 0;
-
-                for (int m = 0; m < 4; m++) {
-                    localMask[m] = L1.numMask[m];
-                }
-                std::memcpy(localRows[0], L1.rows, 8);
-
-                // Search for remaining 3 layers (Z=1,2,3)
-                searchWithLookup(layers, lookup, i + 1, 1, localZCounts, localMask, localRows, localChecked);
-
-                completedRoots++;
-
-                // Update progress every 10 roots
-                if (completedRoots % 10 == 0) {
-                    this->checkedPaths += localChecked;
-                    localChecked = 0;
-
-                    auto currentTime = std::chrono::steady_clock::now();
-                    double elapsed = std::chrono::duration<double>(currentTime - startTime).count();
-                    double progress = (double)completedRoots / n * 100.0;
-                    double speed = (elapsed > 0.1) ? (checkedPaths / 1000000.0) / elapsed : 0;
-
-                    // Estimate remaining time
-                    int eta_seconds = 0;
-                    if (speed > 0 && progress > 0.5) {
-                        double totalPaths = checkedPaths / (progress / 100.0);
-                        double remaining = totalPaths - checkedPaths;
-                        eta_seconds = (int)(remaining / (speed * 1000000.0));
-                    }
-
-                    std::lock_guard<std::mutex> lock(mtx);
-                    std::cout << "\r[PROGRESS] " << std::fixed << std::setprecision(2) << progress
-                              << "% | Roots: " << completedRoots << "/" << n
-                              << " | Speed: " << speed << "M/s"
-                              << " | Checked: " << (checkedPaths / 1000000.0) << "M"
-                              << " | Found: " << foundCount;
-                    if (eta_seconds > 0) {
-                        std::cout << " | ETA: " << (eta_seconds / 60) << "m " << (eta_seconds % 60) << "s";
-                    }
-                    std::cout << " | Elapsed: " << (int)elapsed << "s" << std::flush;
-                }
-            }
-
-            // Add remaining local checked count
-            this->checkedPaths += localChecked;
-        });
-    }
-
-    for (auto &th : threads) th.join();
+    std::cout << "[CubeAssembler] Launching " << nThreads << " worker threads..." << std::endl;
+    std::cout << "[CubeAssembler] Searching " << nRoots << " root layers (work-stealing)\n" << std::endl;
+
+    ProgressReporter reporter(options, "layers", nThreads, nRoots, "Roots");
+    reporter.setFoundCounter([this]() { return foundCount.load(std::memory_order_relaxed); });
+    reporter.start();
+
+    // Time limit: raises the same stop flag as find-first
+    SearchTimer timer(options.timeLimitSeconds, [this, &pool]() {
+        interrupted = true;
+        stopSearch = true;
+        pool.requestStop();
+    });
+
+    pool.run(nRoots, [&](int worker, int i) {
+        if (stopSearch.load(std::memory_order_relaxed)) {
+            pool.requestStop();
+            return;
+        }
+        long localChecked = 0;
+        searchRoot(layers, index, i, failFirst, workerScratch[worker].data(), localChecked, workerProfiles[worker]);
+
+        checkedPaths += localChecked;
+        completedRoots++;
+        reporter.add(worker, localChecked, 1);
+    });
+    for (const SearchProfile &p : workerProfiles) profile.merge(p);
+    timer.stop();
+    reporter.stop();
+    writer.finish();
 
     auto endTime = std::chrono::steady_clock::now();
     auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(endTime - startTime).count();
 
-    std::cout << "\n\n[CubeAssembler] Search complete!" << std::endl;
+    stats.engine = "layers";
+    stats.threads = nThreads;
+    stats.seconds = std::chrono::duration<double>(endTime - startTime).count();
+    stats.pathsChecked = checkedPaths;
+    stats.cubesFound = foundCount;
+    stats.invalidCubes = writer.getInvalidCount();
+    stats.complete = completedRoots == nRoots;
+
+    std::cout << "\n\n[CubeAssembler] " << (interrupted ? "Time limit reached!" : "Search complete!") << std::endl;
     std::cout << "[CubeAssembler] Time: " << elapsed << "s (" << (elapsed / 60) << "m " <<
               (elapsed % 60) << "s)" << std::endl;
     std::cout << "[CubeAssembler] Total paths checked: " << checkedPaths.load() << std::endl;
     std::cout << "[CubeAssembler] Perfect cubes found: " << foundCount.load() << std::endl;
+    if (writer.getInvalidCount() > 0) {
+        std::cout << "[CubeAssembler] WARNING: " << writer.getInvalidCount() << " cube(s) failed verification" << std::endl;
+    }
+
+    writer.writeSummary(interrupted,
+                        {{"Total time", std::to_string(elapsed / 60) + "m " + std::to_string(elapsed % 60) + "s"},
+                         {"Total permutations checked", std::to_string(checkedPaths.load()) + " / 0"},
+                         {"Perfect cubes found", std::to_string(foundCount.load())}});
+    writer.close();
 }
 
-void CubeAssembler::searchWithLookup(const std::vector<Layer> &layers,
-                                     const std::vector<std::vector<int>> &lookup,
+void CubeAssembler::searchWithLookup(const LayerStore &layers,
+                                     const LayerIndex &index,
                                      int layerStartIdx,
                                      int currentZ,
-                                     uint64_t zCounts[3],
-                                     uint64_t currentCubeMask[4],
                                      uint8_t currentCubeRows[4][8],
-                                     long &localChecked)
+                                     uint64_t *allowed,
+                                     long &localChecked,
+                                     SearchProfile &localProfile)
 {
-    if (currentZ == 3) {
-        // Z=3: Calculate target matrix (columns need exactly 4 ones)
-        uint64_t targetMatrix = ~(zCounts[0] | zCounts[1]);
-
-        uint8_t targetFirstRow = (uint8_t)(targetMatrix & 0xFF);
-
-        // Use lookup to find candidates quickly
-        for (int idx : lookup[targetFirstRow]) {
-            if (idx < layerStartIdx) continue;
+    PBC_PROFILE_NODE(localProfile, currentZ);
+
+    // Layers 7-4 are the complements of layers 0-3, so every Z column already
+    // sums to 4 and each layer balances X and Y on its own: any 4 layers that
+    // share no number form a cube. allowed holds the layers sharing no number
+    // with layers 0..currentZ-2 (Z=3 reuses the Z=2 set); the SIMD kernel drops
+    // those colliding with the rest, a block at a time
+    uint64_t cubeNumbers[4] = {0, 0, 0, 0};
+    for (int z = 0; z < currentZ; z++) {
+        for (int y = 0; y < 8; y++) {
+            cubeNumbers[currentCubeRows[z][y] / 64] |= 1ULL << (currentCubeRows[z][y] % 64);
+        }
+    }
+    uint32_t survivors[kFilterBlock];
+    uint64_t *nextAllowed = allowed + compatibility.wordCount();
+
+    // Returns false once the search should unwind
+    auto scan = [&](size_t begin, size_t end) {
+        for (size_t blockStart = begin; blockStart < end; blockStart += kFilterBlock) {
+            size_t blockEnd = std::min(blockStart + kFilterBlock, end);
+
+            // Number collision (each number 0-255 can appear at most once)
+            size_t nSurvivors = CandidateFilter::filter(layers, blockStart, blockEnd, cubeNumbers,
+                                                        allowed, survivors);
+            PBC_PROFILE_PRUNE(localProfile, currentZ, PruneReason::NumberCollision, blockEnd - blockStart - nSurvivors);
+
+            for (size_t k = 0; k < nSurvivors; ++k) {
+                // Find-first or time limit: unwind as soon as another thread raises the flag
+                if (stopSearch.load(std::memory_order_relaxed)) return false;
+
+                const int i = survivors[k];
+                localChecked++;
+                std::memcpy(currentCubeRows[currentZ], layers.rows(i), 8);
+
+                if (currentZ == 3) {
+                    // Found a valid 4-layer combination!
+                    PBC_PROFILE_SOLUTION(localProfile);
+                    if (onCube(currentCubeRows)) return false;
+                    continue;
+                }
 
-            localChecked++;
-            const Layer &cand = layers[idx];
+                // Only Z=2 needs a narrowed set: the Z=3 level filters layer 2's
+                // numbers itself instead of materializing a set per layer 2
+                if (currentZ == 1) {
+                    compatibility.restrict(currentCubeRows[1], allowed, nextAllowed, (i + 1) / 64);
+                }
 
-            // Fast check: exact matrix match
-            if (cand.bitMatrix != targetMatrix) continue;
+                // Recurse
+                searchWithLookup(layers, index, i + 1, currentZ + 1, currentCubeRows,
+                                 currentZ == 1 ? nextAllowed : allowed, localChecked, localProfile);
+            }
+        }
+        return true;
+    };
 
-            // Fast check: number collision
-            if ((cand.numMask[0] & currentCubeMask[0]) ||
-                (cand.numMask[1] & currentCubeMask[1]) ||
-                (cand.numMask[2] & currentCubeMask[2]) ||
-                (cand.numMask[3] & currentCubeMask[3])) continue;
+    // A range of one filter block is cheaper to filter than to walk
+    if (layers.size() - layerStartIdx <= kFilterBlock) {
+        scan(layerStartIdx, layers.size());
+        return;
+    }
 
-            // Found a valid 4-layer combination!
-            Cube c;
+    // Walk [layerStartIdx, n) first-row span by first-row span instead of
+    // scanning it: a span whose first row the cube already uses is dropped
+    // whole. Inside a span the prefix trie does the same for longer prefixes,
+    // and a node where no layer can collide is scanned without descending.
+    // A store not grouped by first row is a single span with no row test
+    const LayerIndex::Span whole = {0, (uint32_t)layers.size(), 0};
+    const bool bySpan = !index.rowSpans().empty();
+    const LayerIndex::Span *span = bySpan ? index.rowSpans().data() : &whole;
+    const LayerIndex::Span *lastSpan = span + (bySpan ? index.rowSpans().size() : 1);
+
+    const LayerPrefixIndex::Node *rootEnd = prefixes.nodes(0) + prefixes.nodeCount(0);
+    const LayerPrefixIndex::Node *next = std::partition_point(prefixes.nodes(0), rootEnd,
+        [layerStartIdx](const LayerPrefixIndex::Node &node) { return (int)node.end <= layerStartIdx; });
+    for (; span != lastSpan; ++span) {
+        if ((int)span->end <= layerStartIdx) continue;
+        const LayerPrefixIndex::Node *spanEnd = std::partition_point(next, rootEnd,
+            [span](const LayerPrefixIndex::Node &node) { return node.begin < span->end; });
+        if (bySpan && ((cubeNumbers[span->row / 64] >> (span->row % 64)) & 1)) {
+            PBC_PROFILE_PRUNE(localProfile, currentZ, PruneReason::NumberCollision,
+                              span->end - std::max<size_t>(span->begin, layerStartIdx));
+            next = spanEnd;
+            continue;
+        }
 
-            // Copy first 3 layers
-            for (int z = 0; z < 3; z++) {
-                std::memcpy(c.data[z], currentCubeRows[z], 8);
+        const LayerPrefixIndex::Node *cursor[LayerPrefixIndex::kLevels];
+        const LayerPrefixIndex::Node *last[LayerPrefixIndex::kLevels];
+        cursor[0] = next;
+        last[0] = spanEnd;
+        next = spanEnd;
+        int level = 0;
+        while (level >= 0) {
+            if (cursor[level] == last[level]) {
+                if (--level >= 0) ++cursor[level];
+                continue;
+            }
+            const LayerPrefixIndex::Node &node = *cursor[level];
+            if ((int)node.end <= layerStartIdx) {
+                ++cursor[level];
+                continue;
+            }
+            const size_t begin = std::max<size_t>(node.begin, layerStartIdx);
+
+            bool numberHit = (node.andNumbers[0] & cubeNumbers[0]) || (node.andNumbers[1] & cubeNumbers[1]) ||
+                             (node.andNumbers[2] & cubeNumbers[2]) || (node.andNumbers[3] & cubeNumbers[3]);
+            if (numberHit) {
+                PBC_PROFILE_PRUNE(localProfile, currentZ, PruneReason::NumberCollision, node.end - begin);
+                ++cursor[level];
+                continue;
             }
 
-            // Add 4th layer
-            std::memcpy(c.data[3], cand.rows, 8);
-
-            // Complete cube with central symmetry (layers 4-7 are complements)
-            for (int z = 0; z < 4; z++) {
-                for (int y = 0; y < 8; y++) {
-                    c.data[7 - z][y] = balancedSet.getComplement(c.data[z][y]);
-                }
+            bool mayCollide = (node.orNumbers[0] & cubeNumbers[0]) || (node.orNumbers[1] & cubeNumbers[1]) ||
+                              (node.orNumbers[2] & cubeNumbers[2]) || (node.orNumbers[3] & cubeNumbers[3]);
+            if (mayCollide && level + 1 < LayerPrefixIndex::kLevels) {
+                cursor[level + 1] = prefixes.nodes(level + 1) + node.firstChild;
+                last[level + 1] = prefixes.nodes(level + 1) + node.lastChild;
+                ++level;
+                continue;
             }
+            if (!scan(begin, node.end)) return;
+            ++cursor[level];
+        }
+    }
+}
 
-            // Save to disk
-            int cubeId = ++foundCount;
-            saveToDisk(c, cubeId);
+void CubeAssembler::searchRoot(const LayerStore &layers,
+                               const LayerIndex &index,
+                               int i,
+                               bool failFirst,
+                               uint64_t *scratch,
+                               long &localChecked,
+                               SearchProfile &localProfile)
+{
+    PBC_PROFILE_NODE(localProfile, 0);
+    if (failFirst) {
+        // Root branch i: layer rootOrder[i] holds rootChain[rootGroup[i]], the
+        // chain's earlier numbers stay unused
+        const uint32_t id = rootOrder[i];
+        const int group = rootGroup[i];
+        FailFirstNode node;
+        node.depth = 1;
+        node.chosen[0] = id;
+        std::memcpy(node.deadNumbers, rootDead, sizeof(rootDead));
+        for (int r = 0; r < 4; r++) node.deadNumbers[layers.rows(id)[r] / 64] |= 1ULL << (layers.rows(id)[r] % 64);
+        for (int g = 0; g < group; g++) node.deadNumbers[rootChain[g] / 64] |= 1ULL << (rootChain[g] % 64);
+        node.freeNumbers = rootFree - 4 - group;
+
+        const size_t words = compatibility.wordCount();
+        compatibility.restrict(layers.rows(id), nullptr, scratch, 0);
+        for (int g = 0; g < group; g++) {
+            const uint64_t *notUsing = compatibility.layersNotUsing(rootChain[g]);
+            for (size_t w = 0; w < words; ++w) scratch[w] &= notUsing[w];
         }
+        searchFailFirst(layers, node, scratch, scratch, localChecked, localProfile);
         return;
     }
 
-    // Recursive case: try adding more layers (Z=1 or Z=2)
-    for (int i = layerStartIdx; i < (int)layers.size(); i++) {
-        const Layer &cand = layers[i];
-
-        // Pruning 1: Z-axis constraint (no column can exceed 4 ones)
-        if (zCounts[2] & cand.bitMatrix) continue;
+    // Initialize state with first layer
+    uint8_t rows[4][8];
+    std::memcpy(rows[0], layers.rows(i), 8);
+    compatibility.restrict(layers.rows(i), nullptr, scratch, (i + 1) / 64);
 
-        // Pruning 2: Number collision (each number 0-255 can appear at most once)
-        if ((cand.numMask[0] & currentCubeMask[0]) ||
-            (cand.numMask[1] & currentCubeMask[1]) ||
-            (cand.numMask[2] & currentCubeMask[2]) ||
-            (cand.numMask[3] & currentCubeMask[3])) continue;
-
-        localChecked++;
-
-        // Bit-slice addition (parallel 64-bit addition for Z-counts)
-        uint64_t nextCounts[3];
-        uint64_t carry0 = zCounts[0] & cand.bitMatrix;
-        nextCounts[0] = zCounts[0] ^ cand.bitMatrix;
-
-        uint64_t carry1 = zCounts[1] & carry0;
-        nextCounts[1] = zCounts[1] ^ carry0;
-
-        nextCounts[2] = zCounts[2] | carry1;
+    // Search for remaining 3 layers (Z=1,2,3)
+    searchWithLookup(layers, index, i + 1, 1, rows, scratch, localChecked, localProfile);
+}
 
-        // Update number mask
-        uint64_t nextMask[4];
-        for (int m = 0; m < 4; m++) {
-            nextMask[m] = currentCubeMask[m] | cand.numMask[m];
+int CubeAssembler::pickNumber(const uint64_t *candidates, const uint64_t dead[4], uint64_t &count) const
+{
+    // Fewest candidates first; ties go to the earlier up number
+    const size_t words = compatibility.wordCount();
+    int best = -1;
+    count = ~0ULL;
+    for (uint8_t v : balancedSet.getUpSet()) {
+        if ((dead[v / 64] >> (v % 64)) & 1) continue;
+        const uint64_t *notUsing = compatibility.layersNotUsing(v);
+        uint64_t c = 0;
+        for (size_t w = 0; w < words; ++w) c += __builtin_popcountll(candidates[w] & ~notUsing[w]);
+        if (c < count) {
+            best = v;
+            count = c;
+            if (count == 0) break;
         }
-
-        // Update rows (no copy, just add new layer)
-        std::memcpy(currentCubeRows[currentZ], cand.rows, 8);
-
-        // Recurse
-        searchWithLookup(layers, lookup, i + 1, currentZ + 1, nextCounts, nextMask, currentCubeRows, localChecked);
     }
+    return best;
 }
 
-void CubeAssembler::saveToDisk(const Cube &cube, int id)
+void CubeAssembler::buildRootOrder(const LayerStore &layers)
 {
-    std::lock_guard<std::mutex> lock(mtx);
-
-    // === COMPLETE VERIFICATION ===
-    int totalOnes = 0;
-    bool allAxesValid = true;
-    std::string errorMsg = "";
+    // Replay the root node's branching: the layers holding the most
+    // constrained number in id order, then the same with that number unused,
+    // until fewer than 16 up numbers (4 layers' worth) are left
+    const size_t words = compatibility.wordCount();
+    std::vector<uint64_t> candidates(words, ~0ULL);
+    for (size_t w = 0; w < words; ++w) {
+        size_t remaining = layers.size() - std::min(layers.size(), w * 64);
+        candidates[w] = remaining >= 64 ? ~0ULL : (1ULL << remaining) - 1;
+    }
 
-    // Count total bits
-    for (int z = 0; z < 8; z++) {
-        for (int y = 0; y < 8; y++) {
-            totalOnes += __builtin_popcount(cube.data[z][y]);
-        }
+    rootOrder.clear();
+    rootGroup.clear();
+    rootChain.clear();
+    std::fill(rootDead, rootDead + 4, 0);
+    rootFree = 0;
+    for (uint8_t v : balancedSet.getUpSet()) {
+        if (compatibility.layersNotUsing(v)) rootFree++;
+        else rootDead[v / 64] |= 1ULL << (v % 64);
     }
 
-    // Verify X-axis (64 lines: each row in each layer)
-    for (int z = 0; z < 8; z++) {
-        for (int y = 0; y < 8; y++) {
-            if (!balancedSet.isBalanced(cube.data[z][y])) {
-                allAxesValid = false;
-                errorMsg += "X-axis FAIL at z=" + std::to_string(z) + " y=" + std::to_string(y) + "\n";
+    uint64_t dead[4];
+    std::memcpy(dead, rootDead, sizeof(dead));
+    for (int free = rootFree; free >= 16; free--) {
+        uint64_t count;
+        int v = pickNumber(candidates.data(), dead, count);
+        const uint64_t *notUsing = compatibility.layersNotUsing((uint8_t)v);
+        for (size_t w = 0; w < words; ++w) {
+            for (uint64_t m = candidates[w] & ~notUsing[w]; m; m &= m - 1) {
+                rootOrder.push_back((uint32_t)(w * 64 + __builtin_ctzll(m)));
+                rootGroup.push_back((uint8_t)rootChain.size());
             }
+            candidates[w] &= notUsing[w];
         }
+        rootChain.push_back((uint8_t)v);
+        dead[v / 64] |= 1ULL << (v % 64);
     }
+}
 
-    // Verify Y-axis (64 lines: bit positions within each layer)
-    for (int z = 0; z < 8; z++) {
-        for (int bitPos = 0; bitPos < 8; bitPos++) {
-            uint8_t yLine = 0;
-            for (int y = 0; y < 8; y++) {
-                if ((cube.data[z][y] >> bitPos) & 1) {
-                    yLine |= (1 << y);
-                }
-            }
-            if (!balancedSet.isBalanced(yLine)) {
-                allAxesValid = false;
-                errorMsg += "Y-axis FAIL at z=" + std::to_string(z) + " bitPos=" + std::to_string(bitPos) + "\n";
+void CubeAssembler::searchFailFirst(const LayerStore &layers,
+                                    const FailFirstNode &node,
+                                    uint64_t *candidates,
+                                    uint64_t *scratch,
+                                    long &localChecked,
+                                    SearchProfile &localProfile)
+{
+    PBC_PROFILE_NODE(localProfile, node.depth);
+    const size_t words = compatibility.wordCount();
+
+    if (node.depth == 3) {
+        // Every candidate completes the set; report it in id order, as the index order does
+        for (size_t w = 0; w < words; ++w) {
+            for (uint64_t m = candidates[w]; m; m &= m - 1) {
+                if (stopSearch.load(std::memory_order_relaxed)) return;
+                uint32_t ids[4] = {node.chosen[0], node.chosen[1], node.chosen[2],
+                                   (uint32_t)(w * 64 + __builtin_ctzll(m))};
+                std::sort(ids, ids + 4);
+                localChecked++;
+                PBC_PROFILE_SOLUTION(localProfile);
+
+                uint8_t rows[4][8];
+                for (int z = 0; z < 4; z++) std::memcpy(rows[z], layers.rows(ids[z]), 8);
+                if (onCube(rows)) return;
             }
         }
+        return;
     }
 
-    // Verify Z-axis (64 lines: columns through layers)
-    for (int y = 0; y < 8; y++) {
-        for (int x = 0; x < 8; x++) {
-            uint8_t zLine = 0;
-            for (int z = 0; z < 8; z++) {
-                if ((cube.data[z][y] >> (7 - x)) & 1) {
-                    zLine |= (1 << z);
+    // The remaining layers need 4 free up numbers each
+    const int needed = 4 * (4 - node.depth);
+    uint64_t *childCandidates = scratch + node.depth * words;
+    FailFirstNode current = node;
+    for (;;) {
+        if (current.freeNumbers < needed) {
+            PBC_PROFILE_PRUNE(localProfile, node.depth, PruneReason::NumberCollision, 1);
+            return;
+        }
+        uint64_t count;
+        const int v = pickNumber(candidates, current.deadNumbers, count);
+        const uint64_t *notUsing = compatibility.layersNotUsing((uint8_t)v);
+
+        // One branch per candidate holding v: the set's layer with that number
+        for (size_t w = 0; w < words && count; ++w) {
+            for (uint64_t m = candidates[w] & ~notUsing[w]; m; m &= m - 1) {
+                if (stopSearch.load(std::memory_order_relaxed)) return;
+                const uint32_t id = (uint32_t)(w * 64 + __builtin_ctzll(m));
+                localChecked++;
+
+                FailFirstNode child = current;
+                child.depth = current.depth + 1;
+                child.chosen[current.depth] = id;
+                for (int r = 0; r < 4; r++) {
+                    child.deadNumbers[layers.rows(id)[r] / 64] |= 1ULL << (layers.rows(id)[r] % 64);
                 }
-            }
-            if (!balancedSet.isBalanced(zLine)) {
-                allAxesValid = false;
-                errorMsg += "Z-axis FAIL at y=" + std::to_string(y) + " x=" + std::to_string(x) + "\n";
+                child.freeNumbers = current.freeNumbers - 4;
+                compatibility.restrict(layers.rows(id), candidates, childCandidates, 0);
+                searchFailFirst(layers, child, childCandidates, scratch, localChecked, localProfile);
             }
         }
+
+        // Last branch: no layer of the set holds v
+        for (size_t w = 0; w < words; ++w) candidates[w] &= notUsing[w];
+        current.deadNumbers[v / 64] |= 1ULL << (v % 64);
+        current.freeNumbers--;
     }
+}
 
-    // Save to file
-    std::ofstream out("PerfectCube_" + std::to_string(id) + ".txt");
-    out << "=== PERFECT BIT CUBE #" << id << " ===\n\n";
-
-    out << "VERIFICATION RESULTS:\n";
-    out << "====================\n";
-    out << "Total 1s: " << totalOnes << " (should be 256) " << (totalOnes == 256 ? "✓" : "✗") << "\n";
-    out << "Total 0s: " << (512 - totalOnes) << " (should be 256) " << ((512 - totalOnes) == 256 ? "✓" : "✗") << "\n";
-    out << "All X-axis lines balanced: " << (allAxesValid ? "✓ YES" : "✗ NO") << "\n";
-    out << "All Y-axis lines balanced: " << (allAxesValid ? "✓ YES" : "✗ NO") << "\n";
-    out << "All Z-axis lines balanced: " << (allAxesValid ? "✓ YES" : "✗ NO") << "\n";
-    out << "VERDICT: " << (allAxesValid && totalOnes == 256 ? "✓✓✓ PERFECT CUBE ✓✓✓" : "✗ INVALID") << "\n\n";
-
-    if (!errorMsg.empty()) {
-        out << "ERRORS:\n" << errorMsg << "\n";
+bool CubeAssembler::recordCube(const uint8_t rows[4][8])
+{
+    Cube c;
+    for (int z = 0; z < 4; z++) {
+        std::memcpy(c.data[z], rows[z], 8);
     }
 
-    // Print each layer
-    for (int z = 0; z < 8; z++) {
-        out << "Layer Z=" << z << ":\n";
+    // Complete cube with central symmetry (layers 4-7 are complements)
+    for (int z = 0; z < 4; z++) {
         for (int y = 0; y < 8; y++) {
-            out << std::bitset<8>(cube.data[z][y]) << " (" << std::setw(3) << (int)cube.data[z][y] << ")\n";
+            c.data[7 - z][y] = balancedSet.getComplement(c.data[z][y]);
         }
-        out << "\n";
     }
 
-    out.close();
+    // Queue for the result writer
+    long cubeId = ++foundCount;
+    if (cubeId == 1) {
+        firstCube = c;
+        firstCubeFound = true;
+    }
+    saveResult(c, cubeId);
+    if (findOnlyFirst) {
+        stopSearch = true;
+        return true;
+    }
+    return false;
+}
 
-    if (allAxesValid && totalOnes == 256) {
-        std::cout << "\n🎉✓✓✓ PERFECT CUBE #" << id << " VERIFIED AND SAVED! ✓✓✓" << std::endl;
-    } else {
-        std::cout << "\n⚠️  WARNING: Cube #" << id << " saved but FAILED verification!" << std::endl;
+void CubeAssembler::saveResult(const Cube &cube, long id)
+{
+    // Verification and I/O happen on the writer thread, off the search threads
+    uint8_t record[kSolutionRecordSize];
+    for (int z = 0; z < 8; z++) {
+        std::memcpy(record + z * 8, cube.data[z], 8);
     }
+    writer.submit(id, record);
 }
@@ -1,36 +1,119 @@
 #ifndef CUBEASSEMBLER_H
 #define CUBEASSEMBLER_H
 
-#include "Layer.h"
+#include "LayerStore.h"
+#include "LayerIndex.h"
+#include "LayerCompatibility.h"
+#include "LayerPrefixIndex.h"
 #include "Cube.h"
 #include "BalancedSet.h"
+#include "ResultWriter.h"
+#include "SearchOptions.h"
+#include "SearchStats.h"
+#include "SearchProfile.h"
 #include <vector>
-#include <mutex>
 #include <atomic>
-#include <fstream>
-#include <bitset>
+#include <functional>
 
 class CubeAssembler
 {
 public:
     CubeAssembler(const BalancedSet &bSet);
-    void assembleParallel(const std::vector<Layer> &layers, int nThreads);
+
+    // index must have been built over layers (or mapped with them from a LayerCache)
+    void assembleParallel(const LayerStore &layers, const LayerIndex &index, const SearchOptions &options);
+
+    long getCubeCount() const { return foundCount; }
+    long getCheckedPaths() const { return checkedPaths; }
+    bool wasInterrupted() const { return interrupted; }
+    const SearchStats &getStats() const { return stats; }
+    const SearchProfile &getProfile() const { return profile; }
+    const Cube *getFirstCube() const { return firstCubeFound ? &firstCube : nullptr; }
 
 private:
+    // The benchmark suite (Benchmark.cpp) times the private kernels directly
+    friend struct BenchAccess;
+
     const BalancedSet &balancedSet;
-    std::mutex mtx;
     std::atomic<long> checkedPaths{0};
-    std::atomic<int> foundCount{0};
+    std::atomic<long> foundCount{0};
+    ResultWriter writer;
+    LayerCompatibility compatibility;
+    LayerPrefixIndex prefixes;  // Index branching: walked by the Z=1..3 levels
+    SearchStats stats;
+    SearchProfile profile;  // Merged from the workers' copies when they finish
+
+    // Raised on the first cube (find-first mode) or when the time limit expires
+    std::atomic<bool> stopSearch{false};
+    std::atomic<bool> firstCubeFound{false};
+    bool findOnlyFirst{false};
+    bool interrupted{false};
+    Cube firstCube;
 
-    void searchWithLookup(const std::vector<Layer> &layers,
-                          const std::vector<std::vector<int>> &lookup,
+    // Layers handed to the SIMD candidate filter per call (survivor buffer on the stack)
+    static constexpr size_t kFilterBlock = 512;
+
+    void searchWithLookup(const LayerStore &layers,
+                          const LayerIndex &index,
                           int layerStartIdx,
                           int currentZ,
-                          uint64_t zCounts[3],
-                          uint64_t currentCubeMask[4],
                           uint8_t currentCubeRows[4][8],
-                          long &localChecked);
-    void saveToDisk(const Cube &cube, int id);
+                          uint64_t *allowed,
+                          long &localChecked,
+                          SearchProfile &localProfile);
+
+    // Layers for root i (rootOrder[i] in fail-first order) and everything
+    // below them; scratch holds 3 candidate bitsets
+    void searchRoot(const LayerStore &layers,
+                    const LayerIndex &index,
+                    int i,
+                    bool failFirst,
+                    uint64_t *scratch,
+                    long &localChecked,
+                    SearchProfile &localProfile);
+
+    // Fail-first branching (--branching=fail-first): the layers are chosen as
+    // an unordered set by deciding up numbers, the one the fewest candidate
+    // layers use first. Each number is held by one of those layers or by none
+    // of the cube's, so every set of 4 layers is reached once
+    struct FailFirstNode {
+        int depth;                   // Layers chosen (1..3)
+        uint32_t chosen[3];
+        uint64_t deadNumbers[4];     // Up numbers of the chosen layers or decided unused
+        int freeNumbers;             // Up numbers neither used nor decided unused
+    };
+
+    // The root node's branching, precomputed so its branches can run in
+    // parallel: branch t takes layer rootOrder[t], which holds up number
+    // rootChain[rootGroup[t]], with rootChain[0..rootGroup[t]) unused
+    std::vector<uint32_t> rootOrder;
+    std::vector<uint8_t> rootGroup;
+    std::vector<uint8_t> rootChain;
+    uint64_t rootDead[4] = {0, 0, 0, 0};  // Up numbers no layer uses
+    int rootFree = 0;
+
+    void buildRootOrder(const LayerStore &layers);
+
+    // Free up number used by the fewest layers of candidates (their number in count)
+    int pickNumber(const uint64_t *candidates, const uint64_t dead[4], uint64_t &count) const;
+
+    // Search below node; candidates are its layers sharing no number with
+    // the chosen ones or the unused ones (narrowed in place)
+    void searchFailFirst(const LayerStore &layers,
+                         const FailFirstNode &node,
+                         uint64_t *candidates,
+                         uint64_t *scratch,
+                         long &localChecked,
+                         SearchProfile &localProfile);
+
+    // Leaf of both branchings, called with layers 0-3 of every cube found;
+    // true stops the search. recordCube() unless replaced (the benchmarks count)
+    using CubeLeaf = std::function<bool(const uint8_t rows[4][8])>;
+    CubeLeaf onCube;
+
+    // Queue the cube of these 4 layers (plus complements); true if the search should stop
+    bool recordCube(const uint8_t rows[4][8]);
+    void saveResult(const Cube &cube, long id);
 };
 
 #endif
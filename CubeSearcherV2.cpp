@@ -1,14 +1,24 @@
 #include "CubeSearcherV2.h"
+#include "CubeVerifier.h"
+#include "ProgressReporter.h"
+#include "WorkStealingPool.h"
+#include "ResultFile.h"
 #include <iostream>
 #include <thread>
+#include <condition_variable>
 #include <iomanip>
 #include <chrono>
 #include <algorithm>
 #include <sstream>
+#include <numeric>
+#include <random>
 
 CubeSearcherV2::CubeSearcherV2(const BalancedSet& bSet)
-    : balancedSet(bSet), totalPathsChecked(0), totalPermutations(0) {
-    openResultFile();
+    : balancedSet(bSet), totalPermutations(0),
+      core(bSet, stopRequested, [this](const std::array<ShiftSet, 8>& cube, TaskContext& ctx) {
+          return acceptCube(cube, ctx);
+      }) {
+    writer.openTimestamped("[INFO]");
 }
 
 int CubeSearcherV2::countUpperHalf(const std::array<uint8_t, 8>& row) const
@@ -73,8 +83,16 @@ bool CubeSearcherV2::passesFilterRule(const std::array<uint8_t, 8>& row) const
     return true;
 }
 
-void CubeSearcherV2::search(int nThreads, bool findOnlyFirst)
+void CubeSearcherV2::search(const SearchOptions& options)
 {
+    const int nThreads = options.nThreads;
+    const bool findOnlyFirst = options.findOnlyFirst;
+    combinations = options.combinations;
+    expandOrderings = options.combinations && options.expandOrderings;
+    symmetric = options.symmetric;
+    shardIndex = options.shardIndex;
+    shardCount = std::max(1, options.shardCount);
+    
     // Use filtered shift sets to reduce search space
     const auto& shiftSets = balancedSet.getFilteredShiftSets();
     int numSets = shiftSets.size();
@@ -96,113 +114,241 @@ void CubeSearcherV2::search(int nThreads, bool findOnlyFirst)
     std::cout << "[PHASE 3] FILTERED PERMUTATION SEARCH" << std::endl;
     std::cout << std::string(70, '=') << std::endl;
     std::cout << "[INFO] Mode: " << (findOnlyFirst ? "FIND FIRST ONLY" : "FIND ALL") << std::endl;
+    std::cout << "[INFO] Enumeration: " << (combinations ? "COMBINATIONS (unordered 8-subsets)" : "PERMUTATIONS")
+              << (expandOrderings ? " + expanded orderings" : "") << std::endl;
+    if (symmetric) {
+        std::cout << "[INFO] Symmetry: CENTRAL (layers 0-3 chosen, layers 7-4 are their complement sets)" << std::endl;
+    }
     std::cout << "[INFO] Filtered shift sets to process: " << numSets << std::endl;
     std::cout << "[INFO] CPU threads available: " << nThreads << std::endl;
     std::cout << "[INFO] Permutation depth: 8 levels (Set 1 fixed, Sets 2-8 from filtered)" << std::endl;
-    std::cout << "[INFO] Total permutations to check: " << totalPermutations << std::endl;
+    std::cout << "[INFO] Total permutations (before Z pruning): " << totalPermutations << std::endl;
     std::cout << "[INFO] Memory usage: ~" << (numSets * 64 / 1024) << " MB estimated" << std::endl;
     std::cout << std::string(70, '=') << std::endl << std::endl;
     
-    resultFile << "================================================\n";
-    resultFile << "Perfect Bit Cube Search Results\n";
-    resultFile << "Mode: " << (findOnlyFirst ? "FIND FIRST ONLY" : "FIND ALL") << "\n";
-    resultFile << "Start time: " << std::chrono::system_clock::now().time_since_epoch().count() << "\n";
-    resultFile << "Total permutations: " << totalPermutations << "\n";
-    resultFile << "Filtered shift sets: " << numSets << "\n";
-    resultFile << "================================================\n\n";
-    resultFile.flush();
+    writer.openCompanion(options.outputFormat, "[INFO]");
+    
+    ResultWriter::Fields header = {
+        {"Mode", findOnlyFirst ? "FIND FIRST ONLY" : "FIND ALL"},
+        {"Enumeration", std::string(combinations ? "COMBINATIONS" : "PERMUTATIONS") +
+                            (expandOrderings ? " (expanded orderings)" : "")}};
+    if (symmetric) header.push_back({"Symmetry", "CENTRAL"});
+    header.push_back({"Total permutations", std::to_string(totalPermutations)});
+    header.push_back({"Filtered shift sets", std::to_string(numSets)});
+    header.push_back({"Shard", std::to_string(shardIndex) + "/" + std::to_string(shardCount)});
+    writer.writeHeader(header);
+    
+    // From here on solutions stream through the asynchronous writer
+    writer.start(expandOrderings, options.progressFormat);
+    
+    // Split the tree into fine-grained subtrees so the pool can balance them
+    core.prepare(combinations, symmetric, kTaskPrefixDepth);
+    const auto& taskPrefixes = core.getTaskPrefixes();
+    int numTasks = taskPrefixes.size();
+    
+    // Shard i/N owns every task whose index is i mod N: deterministic, disjoint,
+    // and round-robin so heavy early roots are spread over all shards
+    int shardTasks = 0;
+    for (int t = 0; t < numTasks; ++t) {
+        if (t % shardCount == shardIndex) shardTasks++;
+    }
+    std::cout << "[INFO] Scheduled tasks: " << shardTasks << " depth-" << kTaskPrefixDepth
+              << " prefixes (work-stealing)";
+    if (shardCount > 1) {
+        std::cout << " | Shard " << shardIndex << "/" << shardCount << " of " << numTasks << " tasks";
+    }
+    std::cout << std::endl << std::endl;
+    
+    // Resume: restore counters and skip tasks an earlier run already finished
+    checkpointState = Checkpoint();
+    if (!options.resumePath.empty()) {
+        if (!checkpointState.load(options.resumePath)) {
+            closeResultFile();
+            return;
+        }
+        if (checkpointState.fingerprint != taskFingerprint() || (int)checkpointState.completedTasks.size() != numTasks) {
+            std::cout << "[CHECKPOINT] ERROR: " << options.resumePath
+                      << " was written by a run with different search settings" << std::endl;
+            std::cout << "[CHECKPOINT] Expected: " << taskFingerprint() << std::endl;
+            std::cout << "[CHECKPOINT] Found:    " << checkpointState.fingerprint << std::endl;
+            closeResultFile();
+            return;
+        }
+        std::cout << "[CHECKPOINT] Resuming from " << options.resumePath << ": "
+                  << checkpointState.countCompleted() << "/" << shardTasks << " tasks done, "
+                  << checkpointState.foundCubes << " cubes found" << std::endl << std::endl;
+    } else {
+        checkpointState.fingerprint = taskFingerprint();
+        checkpointState.completedTasks.assign(numTasks, 0);
+    }
+    checkpointState.resultFiles.push_back(writer.getTextPath());
+    foundCubeCount = checkpointState.foundCubes;
+    resumedCubeCount = checkpointState.foundCubes;
+    nextCubeId = checkpointState.nextCubeId;
+    interrupted = false;
+    stopRequested = false;
+    
+    std::vector<int> pendingTasks;
+    for (int t = 0; t < numTasks; ++t) {
+        if (t % shardCount == shardIndex && !checkpointState.completedTasks[t]) pendingTasks.push_back(t);
+    }
+    
+    // Checkpoints go to --checkpoint, else back to the resumed file, else a default
+    // file when a time limit is set (otherwise the interrupted work would be lost)
+    std::string checkpointPath = options.checkpointPath;
+    if (checkpointPath.empty()) checkpointPath = options.resumePath;
+    if (checkpointPath.empty() && options.timeLimitSeconds > 0 && !options.portfolio) {
+        checkpointPath = "PerfectCube_Checkpoint.txt";
+    }
+    if (!checkpointPath.empty()) {
+        std::cout << "[CHECKPOINT] Saving progress to " << checkpointPath << " every "
+                  << options.checkpointInterval << "s" << std::endl << std::endl;
+    }
     
     auto startTime = std::chrono::steady_clock::now();
-    std::vector<std::thread> threads;
+    WorkStealingPool pool(nThreads);
     
-    int chunkSize = (numSets + nThreads - 1) / nThreads;
+    std::atomic<int> processedTasks{shardTasks - (int)pendingTasks.size()};
+    const long resumedPaths = checkpointState.checkedPaths;
+    std::atomic<long> totalLocalChecked{resumedPaths};
+    std::vector<SearchProfile> workerProfiles(std::max(1, nThreads));
+    std::vector<TaskContext> workerContexts(std::max(1, nThreads));
     
-    std::atomic<int> processedSets{0};
-    std::atomic<long> totalLocalChecked{0};
+    // Pruned subtrees make checked/total meaningless as progress, so report tasks
+    // (portfolio threads have no task list, so they report finished restarts)
+    ProgressReporter reporter(options, "shift", nThreads, options.portfolio ? 0 : shardTasks,
+                              options.portfolio ? "Restarts" : "Tasks");
+    reporter.setBaseline(resumedPaths, processedTasks);
+    reporter.setFoundCounter([this]() { return foundCubeCount.load(std::memory_order_relaxed); });
+    reporter.start();
     
-    for (int t = 0; t < nThreads; ++t) {
-        threads.emplace_back([this, &shiftSets, t, chunkSize, numSets, &processedSets, 
-                             &totalLocalChecked, startTime]() {
-            int start = t * chunkSize;
-            int end = std::min(start + chunkSize, numSets);
-            long localChecked = 0;
+    // Monitor thread: periodic checkpoints and the time limit
+    std::mutex monitorMtx;
+    std::condition_variable monitorCv;
+    bool searchDone = false;
+    std::thread monitor([&]() {
+        if (checkpointPath.empty() && options.timeLimitSeconds <= 0) return;
+        
+        auto deadline = startTime + std::chrono::seconds(options.timeLimitSeconds);
+        auto nextCheckpoint = startTime + std::chrono::seconds(std::max(1, options.checkpointInterval));
+        
+        std::unique_lock<std::mutex> lock(monitorMtx);
+        while (!searchDone) {
+            auto wakeUp = nextCheckpoint;
+            if (options.timeLimitSeconds > 0) wakeUp = std::min(wakeUp, deadline);
+            monitorCv.wait_until(lock, wakeUp, [&]() { return searchDone; });
+            if (searchDone) break;
             
-            for (int i = start; i < end; ++i) {
-                // Exit early if we found the first cube and should stop
-                if (firstCubeFound && shouldStop) {
-                    break;
-                }
-                
-                const ShiftSet& fixedSet = shiftSets[i];
-                std::vector<uint8_t> usedNumbers;
-                std::array<ShiftSet, 8> cube;
-                
-                cube[0] = fixedSet;
-                usedNumbers.push_back(fixedSet.base);
-                
-                searchRecursive(fixedSet, 1, usedNumbers, cube, localChecked);
-                
-                processedSets++;
-                totalLocalChecked += localChecked;
-                localChecked = 0;
-                
-                if (processedSets % 1 == 0) {
-                    auto now = std::chrono::steady_clock::now();
-                    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-                        now - startTime).count();
-                    
-                    long checkedSoFar = totalLocalChecked.load();
-                    double progress = totalPermutations > 0 ? 
-                        (double)checkedSoFar / totalPermutations * 100.0 : 0;
-                    double speed = (elapsed > 0) ? (checkedSoFar / (double)elapsed / 1000000.0) : 0;
-                    
-                    double eta_seconds = 0;
-                    if (speed > 0 && progress > 0.1) {
-                        double remaining = totalPermutations - checkedSoFar;
-                        eta_seconds = remaining / (speed * 1000000.0);
-                    }
-                    
-                    int eta_hours = (int)(eta_seconds / 3600);
-                    int eta_mins = ((int)eta_seconds % 3600) / 60;
-                    int eta_secs = (int)eta_seconds % 60;
-                    
-                    int elapsed_hours = (int)(elapsed / 3600);
-                    int elapsed_mins = (elapsed % 3600) / 60;
-                    int elapsed_secs = elapsed % 60;
-                    
-                    std::lock_guard<std::mutex> lock(mtx);
-                    std::cout << "\r[PROGRESS] " << std::fixed << std::setprecision(2) 
-                              << progress << "% | Checked: " << std::scientific << (double)checkedSoFar
-                              << " / " << (double)totalPermutations
-                              << std::fixed << " | Speed: " << std::setprecision(2) << speed << "M/s"
-                              << " | Found: " << foundCubeCount.load()
-                              << " | Elapsed: " << std::setw(2) << std::setfill('0') 
-                              << elapsed_hours << ":" << elapsed_mins << ":" << elapsed_secs;
-                    if (eta_seconds > 0 && eta_hours >= 0) {
-                        std::cout << " | ETA: " << eta_hours << "h " << eta_mins << "m " << eta_secs << "s";
-                    }
-                    std::cout << std::setfill(' ') << std::flush;
-                }
+            auto now = std::chrono::steady_clock::now();
+            if (options.timeLimitSeconds > 0 && now >= deadline) {
+                // Running tasks finish normally so their results stay consistent;
+                // portfolio runs keep no checkpoint and stop at once
+                interrupted = true;
+                pool.requestStop();
+                if (options.portfolio) stopRequested = true;
+                break;
+            }
+            if (!checkpointPath.empty() && now >= nextCheckpoint) {
+                writeCheckpoint(checkpointPath);
+                nextCheckpoint = now + std::chrono::seconds(std::max(1, options.checkpointInterval));
+            }
+        }
+    });
+    
+    if (options.portfolio) {
+        std::cout << "[INFO] Portfolio: " << nThreads << " thread(s), seeded orders, Luby restarts of "
+                  << kLubyUnit << " nodes (seed " << options.portfolioSeed << ")" << std::endl << std::endl;
+        if (runPortfolio(nThreads, options.portfolioSeed, reporter, totalLocalChecked, workerProfiles)) {
+            processedTasks = shardTasks;
+        }
+    } else {
+        pool.run(pendingTasks.size(), [this, &pool, &pendingTasks, &taskPrefixes, &processedTasks, &totalLocalChecked,
+                                       &workerProfiles, &workerContexts, &reporter](int worker, int k) {
+            // Exit early if we found the first cube and should stop
+            if (stopRequested.load(std::memory_order_relaxed)) {
+                pool.requestStop();
+                return;
+            }
+            
+            int taskIdx = pendingTasks[k];
+            TaskContext& ctx = workerContexts[worker];
+            ctx.checked = 0;
+            ctx.cubeIds.clear();
+            ctx.profile = SearchProfile();
+            core.runTask(taskPrefixes[taskIdx], ctx);
+            
+            totalLocalChecked += ctx.checked;
+            workerProfiles[worker].merge(ctx.profile);
+            reporter.add(worker, ctx.checked, 1);
+            ++processedTasks;
+            
+            // Commit the finished task for the next checkpoint
+            {
+                std::lock_guard<std::mutex> lock(checkpointMtx);
+                checkpointState.completedTasks[taskIdx] = 1;
+                checkpointState.checkedPaths += ctx.checked;
+                checkpointState.foundCubes += (long)ctx.cubeIds.size();
+                checkpointState.cubeIds.insert(checkpointState.cubeIds.end(), ctx.cubeIds.begin(), ctx.cubeIds.end());
+            }
+            
+            if (stopRequested.load(std::memory_order_relaxed)) {
+                pool.requestStop();
             }
         });
     }
     
-    for (auto& th : threads) th.join();
+    {
+        std::lock_guard<std::mutex> lock(monitorMtx);
+        searchDone = true;
+    }
+    monitorCv.notify_all();
+    monitor.join();
+    reporter.stop();
+    
+    if (!checkpointPath.empty()) {
+        writeCheckpoint(checkpointPath);
+        std::cout << "\n[CHECKPOINT] Saved " << checkpointState.countCompleted() << "/" << shardTasks
+                  << " completed tasks to " << checkpointPath << std::endl;
+        if (interrupted) {
+            std::cout << "[CHECKPOINT] Time limit reached; continue with --resume "
+                      << checkpointPath << std::endl;
+        }
+    }
+    
+    // Drain the writer before the summary goes into the same file
+    writer.finish();
     
     auto endTime = std::chrono::steady_clock::now();
     auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(endTime - startTime).count();
     auto minutes = elapsed / 60;
     auto seconds = elapsed % 60;
     
+    profile = SearchProfile();
+    for (const SearchProfile& p : workerProfiles) profile.merge(p);
+    
+    stats.engine = "shift";
+    stats.threads = nThreads;
+    stats.seconds = std::chrono::duration<double>(endTime - startTime).count();
+    stats.pathsChecked = totalLocalChecked.load() - resumedPaths;
+    stats.resumedPaths = resumedPaths;
+    stats.cubesFound = foundCubeCount.load();
+    stats.invalidCubes = writer.getInvalidCount();
+    stats.complete = processedTasks == shardTasks;
+    
     std::cout << "\n" << std::string(70, '=') << std::endl;
-    std::cout << "[COMPLETE] Search finished!" << std::endl;
+    std::cout << (interrupted ? "[STOPPED] Time limit reached!" : "[COMPLETE] Search finished!") << std::endl;
     std::cout << std::string(70, '=') << std::endl;
     std::cout << "[RESULT] Time: " << minutes << "m " << seconds << "s" << std::endl;
     std::cout << "[RESULT] Total permutations: " << totalPermutations << std::endl;
     std::cout << "[RESULT] Total permutations checked: " << totalLocalChecked.load() << std::endl;
-    std::cout << "[RESULT] Progress: " << (totalPermutations > 0 ? 
-        (double)totalLocalChecked.load() / totalPermutations * 100.0 : 0) << "%" << std::endl;
+    std::cout << "[RESULT] Progress: " << (double)processedTasks / shardTasks * 100.0 << "% of tasks" << std::endl;
     std::cout << "[RESULT] Perfect cubes found: " << foundCubeCount.load() << std::endl;
+    if (writer.getInvalidCount() > 0) {
+        std::cout << "[RESULT] WARNING: " << writer.getInvalidCount() << " cube(s) failed verification" << std::endl;
+    }
+    if (combinations) {
+        std::cout << "[RESULT] Ordered layer arrangements: " << getOrderedCubeCount() << std::endl;
+    }
     
     if (foundCubeCount.load() > 0) {
         std::cout << "[SUCCESS] ✓ Found " << foundCubeCount.load() << " solution(s)!" << std::endl;
@@ -212,112 +358,99 @@ void CubeSearcherV2::search(int nThreads, bool findOnlyFirst)
     std::cout << std::string(70, '=') << std::endl;
     
     // Save summary to file
-    resultFile << "\n================================================\n";
-    resultFile << "FINAL RESULTS\n";
-    resultFile << "================================================\n";
-    resultFile << "Total time: " << minutes << "m " << seconds << "s\n";
-    resultFile << "Total permutations checked: " << totalLocalChecked.load() << " / " << totalPermutations << "\n";
-    resultFile << "Progress: " << (totalPermutations > 0 ? 
-        (double)totalLocalChecked.load() / totalPermutations * 100.0 : 0) << "%\n";
-    resultFile << "Perfect cubes found: " << foundCubeCount.load() << "\n";
-    resultFile << "================================================\n";
-    resultFile.flush();
+    std::ostringstream progress;
+    progress << (double)processedTasks / shardTasks * 100.0 << "% of tasks";
+    ResultWriter::Fields summary = {
+        {"Total time", std::to_string(minutes) + "m " + std::to_string(seconds) + "s"},
+        {"Total permutations checked", std::to_string(totalLocalChecked.load()) + " / " + std::to_string(totalPermutations)},
+        {"Progress", progress.str()},
+        {"Perfect cubes found", std::to_string(foundCubeCount.load())}};
+    if (combinations) summary.push_back({"Ordered layer arrangements", std::to_string(getOrderedCubeCount())});
+    writer.writeSummary(interrupted, summary);
     closeResultFile();
 }
 
 bool CubeSearcherV2::validateZAxis(const std::array<ShiftSet, 8>& cube) const
 {
-    // Validate Z-axis: Each (row, bit_position) must have exactly 4 ones across 8 layers
-    for (int row = 0; row < 8; ++row) {
-        for (int bit_pos = 0; bit_pos < 8; ++bit_pos) {
-            int bit_count = 0;
-            for (int layer = 0; layer < 8; ++layer) {
-                uint8_t val = cube[layer].values[row];
-                int bit = (val >> bit_pos) & 1;
-                bit_count += bit;
-            }
-            
-            if (bit_count != 4) {
-                return false;  // Z-axis constraint violated
-            }
-        }
-    }
-    return true;  // All Z-axis constraints satisfied
+    // Each (row, bit_position) must have exactly 4 ones across 8 layers
+    return CubeVerifier::zBalanced(cube);
 }
 
-void CubeSearcherV2::searchRecursive(const ShiftSet& fixedSet,
-                                     int setIdx,
-                                     std::vector<uint8_t>& usedNumbers,
-                                     std::array<ShiftSet, 8>& currentCube,
-                                     long& localChecked)
+bool CubeSearcherV2::acceptCube(const std::array<ShiftSet, 8>& cube, TaskContext& ctx)
 {
-    if (setIdx == 8) {
-        // All 8 sets placed - validate Z-axis before accepting
-        if (!validateZAxis(currentCube)) {
-            return;  // Reject this cube - Z-axis not balanced
-        }
-        
-        // Found a true perfect cube!
-        int resultId = ++foundCubeCount;
-        
-        // Store first cube found
-        if (resultId == 1) {
-            firstCubeFound = true;
-            firstCubeData = currentCube;
-        }
-        
-        saveResult(currentCube, resultId);
-        
-        // Check if we should stop after finding the first cube
-        if (firstCubeFound && shouldStop) {
-            return;  // Signal to stop - but we can't really stop other threads
-        }
-        
-        return;
+    // All 8 sets placed - validate Z-axis before accepting
+    if (!symmetric && !validateZAxis(cube)) return false;
+    recordCube(cube, ctx);
+    return true;
+}
+
+void CubeSearcherV2::recordCube(const std::array<ShiftSet, 8>& cube, TaskContext& ctx)
+{
+    long resultId = ++nextCubeId;
+    long found = ++foundCubeCount;
+    ctx.cubeIds.push_back(resultId);
+    
+    // Store first cube found in this run
+    if (found == resumedCubeCount + 1) {
+        firstCubeData = cube;
+        firstCubeFound.store(true, std::memory_order_release);
     }
     
-    // Use filtered shift sets only
-    const auto& shiftSets = balancedSet.getFilteredShiftSets();
+    saveResult(cube, resultId);
     
-    // Use a fast lookup for used numbers
-    uint32_t usedBitset = 0;
-    for (uint8_t num : usedNumbers) {
-        if (num < 64) {
-            usedBitset |= (1U << num);
-        }
+    // Find-first: every other thread sees the token at its next candidate
+    if (shouldStop) {
+        stopRequested.store(true, std::memory_order_relaxed);
+    }
+}
+
+uint64_t CubeSearcherV2::luby(uint64_t i)
+{
+    // Find k with i <= 2^k - 1; the term is 2^(k-1) at i = 2^k - 1, else recurse
+    for (;;) {
+        int k = 1;
+        while (((1ULL << k) - 1) < i) ++k;
+        if (i == (1ULL << k) - 1) return 1ULL << (k - 1);
+        i -= (1ULL << (k - 1)) - 1;
     }
+}
+
+bool CubeSearcherV2::runPortfolio(int nThreads, uint64_t seed, ProgressReporter& reporter,
+                                  std::atomic<long>& checked, std::vector<SearchProfile>& workerProfiles)
+{
+    const int numSets = core.setCount();
+    std::atomic<bool> exhausted{false};
+    std::vector<std::thread> threads;
     
-    for (const ShiftSet& candidate : shiftSets) {
-        // Exit early if we found the first cube and should stop
-        if (firstCubeFound && shouldStop) {
-            return;
-        }
-        
-        localChecked++;
-        
-        // Check if base number already used
-        bool alreadyUsed = false;
-        if (candidate.base < 64) {
-            alreadyUsed = (usedBitset & (1U << candidate.base)) != 0;
-        } else {
-            alreadyUsed = std::find(usedNumbers.begin(), usedNumbers.end(), candidate.base) 
-                         != usedNumbers.end();
-        }
-        
-        if (alreadyUsed) {
-            continue;
-        }
-        
-        // Filter already done in BalancedSet, no need to recheck
-        
-        // Place this set and continue
-        currentCube[setIdx] = candidate;
-        usedNumbers.push_back(candidate.base);
-        
-        searchRecursive(fixedSet, setIdx + 1, usedNumbers, currentCube, localChecked);
-        
-        usedNumbers.pop_back();
+    for (int t = 0; t < nThreads; ++t) {
+        threads.emplace_back([this, t, numSets, seed, &exhausted, &reporter, &checked, &workerProfiles]() {
+            // Thread 0 starts in the default order, the others in their own seeded shuffle
+            std::mt19937_64 rng(seed + t);
+            std::vector<uint16_t> order(numSets);
+            std::iota(order.begin(), order.end(), 0);
+            TaskContext ctx;
+            
+            for (uint64_t restart = 1; !stopRequested.load(std::memory_order_relaxed); ++restart) {
+                if (restart > 1 || t > 0) {
+                    std::shuffle(order.begin(), order.end(), rng);
+                }
+                ctx.checked = 0;
+                
+                bool complete = core.runOrdered(order, luby(restart) * kLubyUnit, ctx);
+                checked += ctx.checked;
+                reporter.add(t, ctx.checked, 1);
+                if (complete) {
+                    // The whole tree fit in this budget: nothing left for anyone
+                    exhausted = true;
+                    stopRequested = true;
+                }
+            }
+            
+            workerProfiles[t].merge(ctx.profile);
+        });
     }
+    for (auto& th : threads) th.join();
+    return exhausted;
 }
 
 long CubeSearcherV2::calculateTotalPermutations() const
@@ -328,6 +461,26 @@ long CubeSearcherV2::calculateTotalPermutations() const
     
     if (n == 0) return 0;
     
+    // Symmetric mode: 4 of the n/2 complement pairs; ordered, each layer also
+    // picks which set of its pair goes first
+    if (symmetric) {
+        long pairs = n / 2;
+        long total = 1;
+        for (int i = 0; i < 4 && i < pairs; ++i) {
+            total = combinations ? total * (pairs - i) / (i + 1) : total * (n - 2 * i);
+        }
+        return total;
+    }
+    
+    // Combination mode: C(n, 8) unordered subsets
+    if (combinations) {
+        long subsets = 1;
+        for (int i = 0; i < 8 && i < n; ++i) {
+            subsets = subsets * (n - i) / (i + 1);
+        }
+        return subsets;
+    }
+    
     // Rough estimate: n * (n-1) * (n-2) * ... * (n-6) for 7 nested levels
     // This is an underestimate since uniqueness check is not perfect
     long total = 1;
@@ -338,49 +491,45 @@ long CubeSearcherV2::calculateTotalPermutations() const
     return total;
 }
 
-void CubeSearcherV2::openResultFile()
+std::string CubeSearcherV2::taskFingerprint() const
+{
+    std::ostringstream ss;
+    ss << (combinations ? "combinations" : "permutations")
+       << (symmetric ? " symmetric" : "")
+       << " sets=" << core.setCount()
+       << " depth=" << kTaskPrefixDepth
+       << " tasks=" << core.getTaskPrefixes().size()
+       << " shard=" << shardIndex << "/" << shardCount;
+    return ss.str();
+}
+
+void CubeSearcherV2::writeCheckpoint(const std::string& path)
 {
-    std::string filename = "PerfectCube_Results_";
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
+    Checkpoint snapshot;
+    {
+        std::lock_guard<std::mutex> lock(checkpointMtx);
+        snapshot = checkpointState;
+    }
+    snapshot.nextCubeId = nextCubeId;
     
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&time_t), "%Y%m%d_%H%M%S");
-    filename += ss.str() + ".txt";
+    // Solutions written so far must be durable before the checkpoint claims them
+    writer.sync();
     
-    resultFile.open(filename, std::ios::app);
-    if (resultFile.is_open()) {
-        std::cout << "[INFO] Results will be saved to: " << filename << std::endl;
+    if (!snapshot.save(path)) {
+        std::lock_guard<std::mutex> lock(mtx);
+        std::cout << "\n[CHECKPOINT] WARNING: Failed to write " << path << std::endl;
     }
 }
 
 void CubeSearcherV2::closeResultFile()
 {
-    if (resultFile.is_open()) {
-        resultFile.close();
-    }
+    writer.close();
 }
 
-void CubeSearcherV2::saveResult(const std::array<ShiftSet, 8>& cube, int resultId)
+void CubeSearcherV2::saveResult(const std::array<ShiftSet, 8>& cube, long resultId)
 {
-    std::lock_guard<std::mutex> lock(mtx);
-    
-    resultFile << "\n================================================\n";
-    resultFile << "SOLUTION #" << resultId << "\n";
-    resultFile << "================================================\n";
-    
-    for (int i = 0; i < 8; ++i) {
-        resultFile << "Set " << i << " (base: " << (int)cube[i].base << "): ";
-        for (int j = 0; j < 8; ++j) {
-            resultFile << (int)cube[i].values[j];
-            if (j < 7) resultFile << " ";
-        }
-        resultFile << "\n";
-    }
-    
-    resultFile << "================================================\n";
-    resultFile.flush();
-    
-    std::cout << "\n[FOUND!] Perfect Cube #" << resultId << " discovered!\n";
+    // Formatting, verification, ordering expansion and I/O happen on the writer thread
+    uint8_t record[kSolutionRecordSize];
+    ResultFile::packCube(cube, record);
+    writer.submit(resultId, record);
 }
-
@@ -2,6 +2,12 @@
 #define CUBESEARCHERV2_H
 
 #include "BalancedSet.h"
+#include "SearchOptions.h"
+#include "Checkpoint.h"
+#include "ResultWriter.h"
+#include "SearchStats.h"
+#include "SearchProfile.h"
+#include "ShiftSearchCore.h"
 #include <vector>
 #include <cstdint>
 #include <array>
@@ -10,34 +16,92 @@
 #include <fstream>
 #include <chrono>
 
+class ProgressReporter;
+
 class CubeSearcherV2 {
 public:
     CubeSearcherV2(const BalancedSet& bSet);
     
     // Main search method
-    void search(int nThreads, bool findOnlyFirst = true);
+    void search(const SearchOptions& options);
     
     // Get results
-    int getCubeCount() const { return foundCubeCount; }
-    long getTotalPathsChecked() const { return totalPathsChecked; }
+    long getCubeCount() const { return foundCubeCount; }
     long getTotalPermutations() const { return totalPermutations; }
     
+    // Number of ordered layer arrangements represented by the found cubes
+    long getOrderedCubeCount() const { return combinations ? foundCubeCount * kLayerOrderings : foundCubeCount.load(); }
+    
+    // True if the run stopped early on --time-limit (a checkpoint was written)
+    bool wasInterrupted() const { return interrupted; }
+    
     // Get the first found cube (if any)
     const std::array<ShiftSet, 8>* getFirstCube() const { return firstCubeFound ? &firstCubeData : nullptr; }
     
+    // End-of-run statistics (filled when search() returns)
+    const SearchStats& getStats() const { return stats; }
+    
+    // Per-depth node and prune counters of this run (merged from all workers)
+    const SearchProfile& getProfile() const { return profile; }
+    
 private:
+    // The benchmark suite (Benchmark.cpp) times the private kernels directly
+    friend struct BenchAccess;
+
     const BalancedSet& balancedSet;
-    std::atomic<int> foundCubeCount{0};
-    std::atomic<long> totalPathsChecked{0};
+    std::atomic<long> foundCubeCount{0};
+    SearchStats stats;
+    SearchProfile profile;
     std::atomic<bool> shouldStop{false};  // Signal to stop search after first found
+    
+    // Stop token: raised by the thread that records the first cube (find-first)
+    // or by the time limit in portfolio mode; every search loop polls it
+    std::atomic<bool> stopRequested{false};
     long totalPermutations{0};  // Total possible combinations
     
+    // The search loop over the filtered shift sets (pruning, task split,
+    // symmetric completion); its leaves come back to acceptCube()
+    using Core = ShiftSearchCore<8>;
+    using TaskContext = Core::TaskContext;
+    Core core;
+    
+    // Combination mode: candidates only come after the previous set's index
+    bool combinations{false};
+    bool expandOrderings{false};
+    
+    // Symmetric mode: only layers 0..3 are chosen, layer 7 - z is the complement set of layer z
+    bool symmetric{false};
+    
+    // Only tasks with index % shardCount == shardIndex run in this process
+    int shardIndex{0};
+    int shardCount{1};
+    static constexpr long kLayerOrderings = 40320;  // 8!
+    
     // First cube data
-    bool firstCubeFound{false};
+    std::atomic<bool> firstCubeFound{false};  // Published after firstCubeData is written
     std::array<ShiftSet, 8> firstCubeData;
     
     std::mutex mtx;
-    std::ofstream resultFile;
+    
+    // Solutions are queued to this writer's thread; with --format=binary they
+    // go to a SolutionFile next to the text results
+    ResultWriter writer;
+    
+    // Cube ids are handed out separately from foundCubeCount so a resumed run
+    // never reuses an id written by an interrupted task of an earlier segment
+    std::atomic<long> nextCubeId{0};
+    long resumedCubeCount{0};
+    bool interrupted{false};
+    
+    // Completed-task bookkeeping for checkpoints (guarded by checkpointMtx)
+    std::mutex checkpointMtx;
+    Checkpoint checkpointState;
+    
+    // Task list identity: only a run with the same list can resume a checkpoint
+    std::string taskFingerprint() const;
+    
+    // Snapshot completed tasks and write the checkpoint file
+    void writeCheckpoint(const std::string& path);
     
     // Filter rule check: 4 values >=128, 4 values <128, with parity rules
     bool passesFilterRule(const std::array<uint8_t, 8>& row) const;
@@ -56,32 +120,42 @@ private:
     void countParityLower(const std::array<uint8_t, 8>& row,
                          int& evenCount, int& oddCount) const;
     
-    // Recursive search with permutation branching
-    void searchRecursive(const ShiftSet& fixedSet,
-                        int setIdx,
-                        std::vector<uint8_t>& usedNumbers,
-                        std::array<ShiftSet, 8>& currentCube,
-                        long& localChecked);
+    // Tasks fix the first kTaskPrefixDepth layers (part of the checkpoint fingerprint)
+    static constexpr int kTaskPrefixDepth = Core::kMaxTaskDepth;
     
-    // Try to place a shift set at position setIdx
-    void tryPlaceSet(const ShiftSet& fixedSet,
-                    int setIdx,
-                    std::vector<uint8_t>& usedNumbers,
-                    std::array<ShiftSet, 8>& currentCube,
-                    long& localChecked);
+    // Leaf of the core's search: Z-check a full cube (symmetric cubes balance by
+    // construction), then record it; TaskContext's counters are committed to
+    // the checkpoint when the task finishes
+    bool acceptCube(const std::array<ShiftSet, 8>& cube, TaskContext& ctx);
+    
+    // Count, queue and (find-first) announce a verified cube
+    void recordCube(const std::array<ShiftSet, 8>& cube, TaskContext& ctx);
+    
+    // Portfolio mode (--portfolio): every thread runs the core over the whole
+    // tree in its own seeded candidate order and restarts with a fresh order
+    // whenever its node budget runs out; budgets follow the Luby sequence
+    // times kLubyUnit
+    static constexpr uint64_t kLubyUnit = 1 << 14;
+    
+    // Run the portfolio on nThreads threads; true if one of them exhausted the tree.
+    // Counters go to checked and to one profile per thread.
+    bool runPortfolio(int nThreads, uint64_t seed, ProgressReporter& reporter,
+                      std::atomic<long>& checked, std::vector<SearchProfile>& workerProfiles);
+    
+    // i-th term (1-based) of the Luby restart sequence: 1 1 2 1 1 2 4 1 1 2 ...
+    static uint64_t luby(uint64_t i);
     
     // Calculate total possible permutations
     long calculateTotalPermutations() const;
     
-    // Save result to file
-    void saveResult(const std::array<ShiftSet, 8>& cube, int resultId);
+    // Queue a found cube for the result writer
+    void saveResult(const std::array<ShiftSet, 8>& cube, long resultId);
     
-    // Open result file
-    void openResultFile();
     void closeResultFile();
     
     // Validate Z-axis constraint (each column must have 4 ones across 8 layers)
     bool validateZAxis(const std::array<ShiftSet, 8>& cube) const;
+    
 };
 
 #endif
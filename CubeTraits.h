@@ -0,0 +1,144 @@
+#ifndef CUBETRAITS_H
+#define CUBETRAITS_H
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+// Compile-time description of an N×N×N cube whose lines all hold N/2 ones.
+// Everything size-dependent (row word, packed layer matrix, number of
+// bit-sliced Z counter planes, loop bounds) comes from here, so the N=8 code
+// compiles to the same 64-bit operations as the hand-written version.
+
+// 256-bit (or wider) layer matrix for N > 8, with the operators the Z counters need
+template <int W>
+struct WideBoard {
+    uint64_t w[W];
+
+    friend WideBoard operator&(const WideBoard& a, const WideBoard& b) { WideBoard r; for (int i = 0; i < W; ++i) r.w[i] = a.w[i] & b.w[i]; return r; }
+    friend WideBoard operator|(const WideBoard& a, const WideBoard& b) { WideBoard r; for (int i = 0; i < W; ++i) r.w[i] = a.w[i] | b.w[i]; return r; }
+    friend WideBoard operator^(const WideBoard& a, const WideBoard& b) { WideBoard r; for (int i = 0; i < W; ++i) r.w[i] = a.w[i] ^ b.w[i]; return r; }
+    friend WideBoard operator~(const WideBoard& a) { WideBoard r; for (int i = 0; i < W; ++i) r.w[i] = ~a.w[i]; return r; }
+};
+
+template <int N>
+struct CubeTraits {
+    static_assert(N >= 4 && N <= 16 && N % 2 == 0, "cube size must be even, 4..16");
+
+    static constexpr int kSize = N;
+    static constexpr int kHalf = N / 2;                   // Ones per line
+    static constexpr int kCells = N * N;                  // Cells per layer
+    static constexpr int kWords = (kCells + 63) / 64;     // 64-bit words per layer matrix
+    static constexpr uint32_t kValues = 1u << N;          // Distinct row values
+    static constexpr uint32_t kRowMask = kValues - 1;
+
+    // Balanced rows, C(N, N/2): an upper bound on the number of shift sets
+    static constexpr uint32_t binomial(int n, int k) { return k == 0 ? 1 : binomial(n - 1, k - 1) * n / k; }
+    static constexpr uint32_t kBalanced = binomial(N, kHalf);
+
+    // Bit-sliced counter planes needed to count up to kHalf (3 for N=8)
+    static constexpr int planesFor(int v) { return v == 0 ? 0 : 1 + planesFor(v >> 1); }
+    static constexpr int kPlanes = planesFor(kHalf);
+
+    using Row = typename std::conditional<(N <= 8), uint8_t, uint16_t>::type;
+
+    // Packed layer: cell (row r, bit b) is bit r*N + b
+    using Board = typename std::conditional<(kWords == 1), uint64_t, WideBoard<kWords>>::type;
+
+    // Bits of a board that correspond to cells (N=6 leaves the top 28 bits unused)
+    static Board cellMask()
+    {
+        Board m = zero();
+        for (int c = 0; c < kCells; ++c) setBit(m, c);
+        return m;
+    }
+
+    static Board zero()
+    {
+        Board b;
+        clear(b);
+        return b;
+    }
+
+    static bool isZero(const uint64_t& b) { return b == 0; }
+    static bool isZero(const WideBoard<kWords>& b)
+    {
+        uint64_t any = 0;
+        for (int i = 0; i < kWords; ++i) any |= b.w[i];
+        return any == 0;
+    }
+
+    static void clear(uint64_t& b) { b = 0; }
+    static void clear(WideBoard<kWords>& b) { for (int i = 0; i < kWords; ++i) b.w[i] = 0; }
+
+    static void setBit(uint64_t& b, int bit) { b |= 1ULL << bit; }
+    static void setBit(WideBoard<kWords>& b, int bit) { b.w[bit / 64] |= 1ULL << (bit % 64); }
+
+    static bool testBit(const uint64_t& b, int bit) { return (b >> bit) & 1; }
+    static bool testBit(const WideBoard<kWords>& b, int bit) { return (b.w[bit / 64] >> (bit % 64)) & 1; }
+
+    // Pack N rows into a layer board
+    template <typename Rows>
+    static Board pack(const Rows& rows)
+    {
+        Board b = zero();
+        for (int r = 0; r < N; ++r) {
+            for (int bit = 0; bit < N; ++bit) {
+                if ((rows[r] >> bit) & 1) setBit(b, r * N + bit);
+            }
+        }
+        return b;
+    }
+
+    // Cells holding kHalf ones (counters never exceed kHalf, so the planes of
+    // kHalf's set bits are enough)
+    static Board full(const Board planes[kPlanes])
+    {
+        Board f = planes[kPlanes - 1];
+        for (int p = 0; p < kPlanes - 1; ++p) {
+            if ((kHalf >> p) & 1) f = f & planes[p];
+        }
+        return f;
+    }
+
+    // Cells holding at least m ones (bit-serial compare from the top plane)
+    static Board atLeast(const Board planes[kPlanes], int m)
+    {
+        Board gt = zero();
+        Board eq = ~zero();
+        for (int p = kPlanes - 1; p >= 0; --p) {
+            if ((m >> p) & 1) {
+                eq = eq & planes[p];
+            } else {
+                gt = gt | (eq & planes[p]);
+                eq = eq & ~planes[p];
+            }
+        }
+        return gt | eq;
+    }
+
+    // True if every cell holds at least m ones (always for m <= 0)
+    static bool allAtLeast(const Board planes[kPlanes], int m, const Board& cells)
+    {
+        return m <= 0 || isZero(cells & ~atLeast(planes, m));
+    }
+
+    // Add one layer to the bit-sliced Z counters of placedLayers - 1 layers;
+    // false if a cell overflows kHalf or can no longer reach it with the
+    // layers left
+    static bool addLayer(const Board counts[kPlanes], const Board& matrix, int placedLayers,
+                         Board next[kPlanes], const Board& cells)
+    {
+        if (!isZero(full(counts) & matrix)) return false;
+
+        Board carry = matrix;
+        for (int p = 0; p < kPlanes; ++p) {
+            next[p] = counts[p] ^ carry;
+            carry = counts[p] & carry;
+        }
+
+        return allAtLeast(next, placedLayers - kHalf, cells);
+    }
+};
+
+#endif
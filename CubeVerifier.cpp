@@ -0,0 +1,192 @@
+#include "CubeVerifier.h"
+#include "ResultFile.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+// Records per pool task in verifyFile
+constexpr uint64_t kVerifyBlock = 1 << 16;
+
+// Failures listed by verifyFile (the count covers all of them)
+constexpr size_t kReportedFailures = 10;
+
+}
+
+int CubeCheck::failedLines() const
+{
+    return __builtin_popcountll(badX) + __builtin_popcountll(badY) + __builtin_popcountll(badZ);
+}
+
+std::string CubeCheck::describe(int maxLines) const
+{
+    std::ostringstream ss;
+    int listed = 0;
+    auto list = [&](uint64_t mask, const char* axis, const char* major, const char* minor) {
+        for (int line = 0; line < 64 && listed < maxLines; ++line) {
+            if (!((mask >> line) & 1)) continue;
+            ss << (listed++ ? ", " : "") << axis << " " << major << "=" << line / 8
+               << " " << minor << "=" << line % 8;
+        }
+    };
+    list(badX, "X", "z", "row");
+    list(badY, "Y", "z", "bit");
+    list(badZ, "Z", "row", "bit");
+    if (failedLines() > listed) ss << ", ... (" << failedLines() << " lines)";
+    return ss.str();
+}
+
+void CubeVerifier::pack(const uint8_t cube[kSolutionRecordSize], uint64_t layers[8])
+{
+    for (int z = 0; z < 8; ++z) {
+        uint64_t m = 0;
+        for (int row = 0; row < 8; ++row) m |= (uint64_t)cube[z * 8 + row] << (row * 8);
+        layers[z] = m;
+    }
+}
+
+void CubeVerifier::pack(const std::array<ShiftSet, 8>& cube, uint64_t layers[8])
+{
+    for (int z = 0; z < 8; ++z) {
+        uint64_t m = 0;
+        for (int row = 0; row < 8; ++row) m |= (uint64_t)cube[z].values[row] << (row * 8);
+        layers[z] = m;
+    }
+}
+
+uint64_t CubeVerifier::zExactlyFour(const uint64_t layers[8])
+{
+    // Bit-sliced per-cell sum of the 8 layers (planes 1, 2, 4, 8)
+    uint64_t p0 = 0, p1 = 0, p2 = 0, p3 = 0;
+    for (int z = 0; z < 8; ++z) {
+        uint64_t carry = p0 & layers[z];
+        p0 ^= layers[z];
+        uint64_t carry1 = p1 & carry;
+        p1 ^= carry;
+        p3 |= p2 & carry1;
+        p2 ^= carry1;
+    }
+    return p2 & ~(p0 | p1 | p3);
+}
+
+CubeCheck CubeVerifier::check(const uint64_t layers[8])
+{
+    CubeCheck result;
+    for (int z = 0; z < 8; ++z) {
+        result.badX |= (uint64_t)unbalancedBytes(layers[z]) << (z * 8);
+        result.badY |= (uint64_t)unbalancedBytes(transpose(layers[z])) << (z * 8);
+    }
+    result.badZ = ~zExactlyFour(layers);
+    return result;
+}
+
+CubeCheck CubeVerifier::check(const uint8_t cube[kSolutionRecordSize])
+{
+    uint64_t layers[8];
+    pack(cube, layers);
+    return check(layers);
+}
+
+CubeCheck CubeVerifier::check(const std::array<ShiftSet, 8>& cube)
+{
+    uint64_t layers[8];
+    pack(cube, layers);
+    return check(layers);
+}
+
+bool CubeVerifier::zBalanced(const uint64_t layers[8])
+{
+    return zExactlyFour(layers) == ~0ULL;
+}
+
+bool CubeVerifier::zBalanced(const std::array<ShiftSet, 8>& cube)
+{
+    uint64_t layers[8];
+    pack(cube, layers);
+    return zBalanced(layers);
+}
+
+int CubeVerifier::verifyFile(const std::string& path, int nThreads)
+{
+    auto startTime = std::chrono::steady_clock::now();
+    WorkStealingPool pool(nThreads);
+
+    // Each block keeps its first few failures, so the report lists them in file order
+    struct BlockResult {
+        uint64_t invalid = 0;
+        std::vector<std::pair<uint64_t, CubeCheck>> failures;
+    };
+    uint64_t count = 0;
+    uint64_t invalid = 0;
+    size_t reported = 0;
+
+    // Check records [0, n) on the pool; they are solutions count+1 .. count+n
+    auto verifyBatch = [&](const uint8_t* records, uint64_t n) {
+        const int nBlocks = (int)((n + kVerifyBlock - 1) / kVerifyBlock);
+        std::vector<BlockResult> blocks(nBlocks);
+        pool.run(nBlocks, [&](int, int block) {
+            BlockResult& result = blocks[block];
+            uint64_t end = std::min<uint64_t>(n, (uint64_t)(block + 1) * kVerifyBlock);
+            for (uint64_t i = (uint64_t)block * kVerifyBlock; i < end; ++i) {
+                CubeCheck cubeCheck = check(records + i * kSolutionRecordSize);
+                if (cubeCheck.perfect()) continue;
+                result.invalid++;
+                if (result.failures.size() < kReportedFailures) result.failures.emplace_back(count + i, cubeCheck);
+            }
+        });
+        for (const BlockResult& result : blocks) {
+            invalid += result.invalid;
+            for (const auto& failure : result.failures) {
+                if (reported == kReportedFailures) break;
+                reported++;
+                std::cout << "[VERIFY] Solution #" << failure.first + 1 << " FAILED: "
+                          << failure.second.describe() << std::endl;
+            }
+        }
+        count += n;
+    };
+
+    // Fixed-record binary files are verified in place; text results and delta
+    // files are decoded into a bounded buffer that is verified whenever it fills
+    std::vector<uint8_t> buffer;
+    const size_t bufferRecords = kVerifyBlock * (size_t)std::max(1, nThreads) * 4;
+    auto append = [&](const uint8_t* cube) {
+        buffer.insert(buffer.end(), cube, cube + kSolutionRecordSize);
+        if (buffer.size() == bufferRecords * kSolutionRecordSize) {
+            verifyBatch(buffer.data(), bufferRecords);
+            buffer.clear();
+        }
+    };
+
+    if (SolutionFileReader::isSolutionFile(path)) {
+        SolutionFileReader reader;
+        if (!reader.open(path)) return 1;
+        if (!reader.isDelta()) {
+            if (reader.size() > 0) verifyBatch(reader.record(0), reader.size());
+        } else {
+            reader.forEach([&](const uint8_t* cube) {
+                append(cube);
+                return true;
+            });
+        }
+    } else {
+        ResultFileSummary summary;
+        bool ok = ResultFile::read(path, summary, [&](const StoredSolution& solution) {
+            uint8_t record[kSolutionRecordSize];
+            ResultFile::packCube(solution.layers, record);
+            append(record);
+        });
+        if (!ok) return 1;
+    }
+    if (!buffer.empty()) verifyBatch(buffer.data(), buffer.size() / kSolutionRecordSize);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "[VERIFY] " << path << ": " << count << " cube(s), " << (count - invalid)
+              << " perfect, " << invalid << " invalid (" << nThreads << " thread(s), "
+              << seconds << "s)" << std::endl;
+    return invalid == 0 ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+#ifndef CUBEVERIFIER_H
+#define CUBEVERIFIER_H
+
+#include "BalancedSet.h"
+#include "SolutionFile.h"
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Failing lines of one 8×8×8 cube, one bit per line (all zero = perfect cube)
+struct CubeCheck {
+    uint64_t badX = 0;   // Bit z*8 + row: row of layer z
+    uint64_t badY = 0;   // Bit z*8 + bit: bit position across the rows of layer z
+    uint64_t badZ = 0;   // Bit row*8 + bit: cell (row, bit) across the 8 layers
+
+    bool perfect() const { return (badX | badY | badZ) == 0; }
+    int failedLines() const;
+
+    // "X z=0 row=3, Z row=1 bit=2, ..." (at most maxLines entries)
+    std::string describe(int maxLines = 8) const;
+};
+
+// Bit-parallel check of all 192 lines of a cube packed into 512 bits (one
+// 64-bit word per layer, row r in bits 8r..8r+7). X lines are per-byte
+// popcounts of each word, Y lines the same after an 8×8 bit-matrix transpose,
+// and Z lines a bit-sliced sum of the 8 words.
+class CubeVerifier {
+public:
+    static CubeCheck check(const uint64_t layers[8]);
+    static CubeCheck check(const uint8_t cube[kSolutionRecordSize]);
+    static CubeCheck check(const std::array<ShiftSet, 8>& layers);
+
+    // Z lines only (shift-set layers are X/Y balanced by construction)
+    static bool zBalanced(const uint64_t layers[8]);
+    static bool zBalanced(const std::array<ShiftSet, 8>& layers);
+
+    // Verify every solution of a result file (.txt, or a .bin SolutionFile) on
+    // nThreads threads and print a report; 0 if all cubes are perfect
+    static int verifyFile(const std::string& path, int nThreads);
+
+    // Transpose an 8×8 bit matrix: bit r*8 + c moves to bit c*8 + r
+    static uint64_t transpose(uint64_t m)
+    {
+        uint64_t t;
+        t = (m ^ (m >> 7)) & 0x00AA00AA00AA00AAULL;
+        m = m ^ t ^ (t << 7);
+        t = (m ^ (m >> 14)) & 0x0000CCCC0000CCCCULL;
+        m = m ^ t ^ (t << 14);
+        t = (m ^ (m >> 28)) & 0x00000000F0F0F0F0ULL;
+        m = m ^ t ^ (t << 28);
+        return m;
+    }
+
+    // Bit i set if byte i of m does not hold exactly 4 ones
+    static uint8_t unbalancedBytes(uint64_t m)
+    {
+        m = m - ((m >> 1) & 0x5555555555555555ULL);
+        m = (m & 0x3333333333333333ULL) + ((m >> 2) & 0x3333333333333333ULL);
+        m = (m + (m >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+
+        // Per-byte counts are 0..8: fold each byte's low nibble into bit 0, then
+        // gather the 8 flags into the top byte
+        m ^= 0x0404040404040404ULL;
+        m = (m | (m >> 1) | (m >> 2) | (m >> 3)) & 0x0101010101010101ULL;
+        return (uint8_t)((m * 0x0102040810204080ULL) >> 56);
+    }
+
+private:
+    static void pack(const uint8_t cube[kSolutionRecordSize], uint64_t layers[8]);
+    static void pack(const std::array<ShiftSet, 8>& cube, uint64_t layers[8]);
+
+    // Cells (bit row*8 + bit) holding exactly 4 ones across the layers
+    static uint64_t zExactlyFour(const uint64_t layers[8]);
+};
+
+#endif
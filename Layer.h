@@ -2,17 +2,19 @@
 #define LAYER_H
 
 #include <cstdint>
-#include <vector>
+#include <type_traits>
 
+// One balanced 8x8 layer; its numbers are the rows (all distinct), so
+// numMask is the only per-layer number set
 struct Layer {
     uint8_t rows[8];
-    std::vector<uint8_t> uniqueNumbers; 
-    uint64_t bitMatrix;
     uint64_t numMask[4];
     
-    Layer() : bitMatrix(0) {
+    Layer() {
         for(int i=0; i<4; ++i) numMask[i] = 0;
     }
 };
 
+static_assert(std::is_trivially_copyable<Layer>::value, "Layer must stay trivially copyable");
+
 #endif
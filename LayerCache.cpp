@@ -0,0 +1,153 @@
+#include "LayerCache.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char kLayerCacheMagic[8] = {'P', 'B', 'C', 'L', 'A', 'Y', '0', '1'};
+
+// Payload offsets of every array (relative to the end of the header)
+struct Layout {
+    size_t masks[4];
+    size_t rows;
+    size_t rowStart;
+    size_t rowIds;
+    size_t total;
+};
+
+Layout layout(size_t layerCount)
+{
+    const size_t padded = LayerStore::paddedSize(layerCount);
+    Layout l;
+    size_t offset = 0;
+    auto place = [&offset](size_t bytes) {
+        size_t at = offset;
+        offset = (offset + bytes + 63) / 64 * 64;
+        return at;
+    };
+    for (int w = 0; w < 4; ++w) {
+        l.masks[w] = place(padded * sizeof(uint64_t));
+    }
+    l.rows = place(padded * 8);
+    l.rowStart = place(257 * sizeof(uint32_t));
+    l.rowIds = place(layerCount * sizeof(uint32_t));
+    l.total = offset;
+    return l;
+}
+
+// FNV-1a over 64-bit words (payload sizes are multiples of 64 bytes)
+uint64_t checksum(const uint8_t* data, size_t size)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+}
+
+bool LayerCache::save(const std::string& path, uint64_t rulesFingerprint, const LayerStore& layers,
+                      const LayerIndex& index)
+{
+    const LayerIndex::Arrays& arrays = index.arrays();
+    const size_t n = layers.size();
+    const size_t padded = LayerStore::paddedSize(n);
+    Layout l = layout(n);
+
+    std::vector<uint8_t> payload(l.total, 0);
+    auto put = [&payload](size_t offset, const void* src, size_t bytes) {
+        if (bytes) std::memcpy(payload.data() + offset, src, bytes);
+    };
+    for (int w = 0; w < 4; ++w) {
+        put(l.masks[w], layers.numMaskPlane(w), padded * sizeof(uint64_t));
+    }
+    if (n) put(l.rows, layers.rows(0), padded * 8);
+    put(l.rowStart, arrays.rowStart, 257 * sizeof(uint32_t));
+    put(l.rowIds, arrays.rowIds, n * sizeof(uint32_t));
+
+    LayerCacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kLayerCacheMagic, 8);
+    header.version = kLayerCacheVersion;
+    header.headerSize = sizeof(LayerCacheHeader);
+    header.layerCount = n;
+    header.payloadSize = l.total;
+    header.checksum = checksum(payload.data(), payload.size());
+    header.rulesFingerprint = rulesFingerprint;
+
+    // Write + fsync a temporary file, then atomically replace the old cache
+    std::string tmpPath = path + ".tmp";
+    FILE* f = std::fopen(tmpPath.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1;
+    ok = (std::fwrite(payload.data(), 1, payload.size(), f) == payload.size()) && ok;
+    ok = (std::fflush(f) == 0) && ok;
+#ifndef _WIN32
+    ok = (fsync(fileno(f)) == 0) && ok;
+#endif
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+#ifdef _WIN32
+    std::remove(path.c_str());
+#endif
+    return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+bool LayerCache::open(const std::string& path, uint64_t rulesFingerprint, LayerStore& layers,
+                      LayerIndex& index)
+{
+    file.close();
+    if (!file.open(path)) return false;
+
+    LayerCacheHeader header;
+    if (file.size() < sizeof(header)) {
+        std::cout << "[LayerCache] " << path << " is truncated; rebuilding" << std::endl;
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, kLayerCacheMagic, 8) != 0 || header.headerSize != sizeof(header)) {
+        std::cout << "[LayerCache] " << path << " is not a layer cache; rebuilding" << std::endl;
+        return false;
+    }
+    if (header.version != kLayerCacheVersion) {
+        std::cout << "[LayerCache] " << path << " has version " << header.version
+                  << " (expected " << kLayerCacheVersion << "); rebuilding" << std::endl;
+        return false;
+    }
+    if (header.rulesFingerprint != rulesFingerprint) {
+        std::cout << "[LayerCache] " << path << " was written under other generator rules; rebuilding"
+                  << std::endl;
+        return false;
+    }
+
+    Layout l = layout(header.layerCount);
+    const uint8_t* payload = file.data() + sizeof(header);
+    if (header.payloadSize != l.total || file.size() != sizeof(header) + l.total ||
+        checksum(payload, l.total) != header.checksum) {
+        std::cout << "[LayerCache] " << path << " is corrupt; rebuilding" << std::endl;
+        return false;
+    }
+
+    const uint64_t* masks[4];
+    for (int w = 0; w < 4; ++w) {
+        masks[w] = reinterpret_cast<const uint64_t*>(payload + l.masks[w]);
+    }
+    layers.attach(header.layerCount, masks, payload + l.rows);
+
+    LayerIndex::Arrays arrays;
+    arrays.layerCount = header.layerCount;
+    arrays.rowStart = reinterpret_cast<const uint32_t*>(payload + l.rowStart);
+    arrays.rowIds = reinterpret_cast<const uint32_t*>(payload + l.rowIds);
+    index.attach(arrays);
+    return true;
+}
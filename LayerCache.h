@@ -0,0 +1,48 @@
+#ifndef LAYERCACHE_H
+#define LAYERCACHE_H
+
+#include "LayerIndex.h"
+#include "LayerStore.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <string>
+
+// On-disk cache of the generated layers and their LayerIndex.
+//
+// A 64-byte header followed by the raw LayerStore and LayerIndex arrays, each
+// starting on a 64-byte boundary, in the order listed in layout(). Opening
+// maps the file and points a LayerStore / LayerIndex straight at the arrays
+// (no parsing); the header's checksum covers everything after the header.
+// Bump kLayerCacheVersion whenever the format changes. The header also carries
+// LayerGenerator::rulesFingerprint(), so a cache written by a generator with
+// other rules (a different layer set or order) is rebuilt, not reused.
+struct LayerCacheHeader {
+    char magic[8];          // "PBCLAY01"
+    uint32_t version;       // kLayerCacheVersion
+    uint32_t headerSize;    // sizeof(LayerCacheHeader)
+    uint64_t layerCount;
+    uint64_t payloadSize;   // Bytes after the header
+    uint64_t checksum;      // Of the payload
+    uint64_t rulesFingerprint;  // LayerGenerator::rulesFingerprint() of the writer
+    uint8_t reserved[16];
+};
+static_assert(sizeof(LayerCacheHeader) == 64, "LayerCacheHeader must stay 64 bytes");
+
+constexpr uint32_t kLayerCacheVersion = 4;
+
+class LayerCache {
+public:
+    // Write store + index to path (temporary file + rename, like checkpoints)
+    static bool save(const std::string& path, uint64_t rulesFingerprint, const LayerStore& layers,
+                     const LayerIndex& index);
+
+    // Map path and attach layers / index to it; false (with a message) if the
+    // file is missing, from another version, written under other generator
+    // rules than rulesFingerprint, or corrupt. The cache must outlive both objects.
+    bool open(const std::string& path, uint64_t rulesFingerprint, LayerStore& layers, LayerIndex& index);
+
+private:
+    MappedFile file;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#include "LayerCompatibility.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+void LayerCompatibility::build(const LayerStore& layers, int nThreads)
+{
+    const size_t n = layers.size();
+    words = (n + 63) / 64;
+
+    int nSlots = 0;
+    std::fill(numberSlot, numberSlot + 256, -1);
+    for (size_t i = 0; i < n; ++i) {
+        for (int r = 0; r < 8; ++r) {
+            uint8_t v = layers.rows(i)[r];
+            if (numberSlot[v] < 0) numberSlot[v] = nSlots++;
+        }
+    }
+    bits.assign((size_t)nSlots * words, 0);
+
+    // Tasks own disjoint word ranges, so the bitsets are filled without locks
+    const size_t wordsPerTask = 256;
+    const int nTasks = (int)((words + wordsPerTask - 1) / wordsPerTask);
+    WorkStealingPool pool(std::max(1, nThreads));
+    pool.run(nTasks, [&](int, int task) {
+        size_t firstWord = task * wordsPerTask;
+        size_t lastWord = std::min(words, firstWord + wordsPerTask);
+        for (int s = 0; s < nSlots; ++s) {
+            uint64_t* slotBits = bits.data() + s * words;
+            for (size_t w = firstWord; w < lastWord; ++w) {
+                // Padding bits past the last layer stay 0
+                size_t remaining = n - w * 64;
+                slotBits[w] = remaining >= 64 ? ~0ULL : (1ULL << remaining) - 1;
+            }
+        }
+        for (size_t i = firstWord * 64; i < std::min(n, lastWord * 64); ++i) {
+            for (int r = 0; r < 8; ++r) {
+                int s = numberSlot[layers.rows(i)[r]];
+                bits[s * words + i / 64] &= ~(1ULL << (i % 64));
+            }
+        }
+    });
+}
+
+void LayerCompatibility::restrict(const uint8_t rows[8], const uint64_t* in, uint64_t* out,
+                                  size_t firstWord) const
+{
+    const uint64_t* sets[8];
+    int nSets = 0;
+    for (int r = 0; r < 8; ++r) {
+        // A number no layer uses rules nothing out
+        int s = numberSlot[rows[r]];
+        if (s >= 0) sets[nSets++] = notUsing(s);
+    }
+    for (size_t w = firstWord; w < words; ++w) {
+        uint64_t acc = in ? in[w] : ~0ULL;
+        for (int k = 0; k < nSets; ++k) {
+            acc &= sets[k][w];
+        }
+        out[w] = acc;
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef LAYERCOMPATIBILITY_H
+#define LAYERCOMPATIBILITY_H
+
+#include "LayerStore.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Number-disjointness of layers as bitsets over layer ids (bit i = layer i).
+// A full layer x layer matrix would need N^2 bits (~200 GB for 1.26M layers),
+// but two layers are compatible exactly when neither uses a number of the
+// other, so one "layers not using v" bitset per number is enough: the
+// compatibility set of a layer is the AND of the sets of its 8 numbers.
+// The assembler keeps one such set per depth and narrows it as it descends.
+class LayerCompatibility {
+public:
+    void build(const LayerStore& layers, int nThreads);
+
+    // 64-bit words per bitset (covers LayerStore's padded size)
+    size_t wordCount() const { return words; }
+
+    // out = in & (layers sharing no number with rows), for words >= firstWord.
+    // in == nullptr stands for "all layers".
+    void restrict(const uint8_t rows[8], const uint64_t* in, uint64_t* out, size_t firstWord) const;
+
+    // Layers not using number (nullptr when no layer uses it)
+    const uint64_t* layersNotUsing(uint8_t number) const
+    {
+        return numberSlot[number] < 0 ? nullptr : notUsing(numberSlot[number]);
+    }
+
+    // Bytes held by the per-number bitsets
+    size_t footprint() const { return bits.size() * sizeof(uint64_t); }
+
+private:
+    size_t words = 0;
+
+    // numberSlot[v]: index of v's bitset, or -1 when no layer uses v
+    int numberSlot[256];
+    std::vector<uint64_t> bits;   // slot-major, words per slot
+
+    const uint64_t* notUsing(int slot) const { return bits.data() + slot * words; }
+};
+
+#endif
@@ -1,40 +1,109 @@
 #include "LayerGenerator.h"
+#include "ProgressReporter.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <bitset>
 
-LayerGenerator::LayerGenerator(const BalancedSet &bSet) : balancedSet(bSet)
-{
-    for (int i = 0; i < 8; ++i) {
-        colCounts[i] = 0;  // Z-axis bit counts
-        yAxisCounts[i] = 0; // Y-axis bit counts
-    }
-}
+LayerGenerator::LayerGenerator(const BalancedSet &bSet) : balancedSet(bSet) {}
 
-void LayerGenerator::generate()
+void LayerGenerator::generate(const SearchOptions& options)
 {
+    const int nThreads = std::max(1, options.nThreads);
     std::cout << "[LayerGen] Starting backtrack search for valid 8x8 layers..." << std::endl;
     std::cout << "[LayerGen] Constraint: X-axis (rows), Y-axis (bit positions), Z-axis (columns) all balanced" << std::endl;
 
-    uint8_t rows[8];
-    uint64_t usedMask = 0;
+    const auto &upSet = balancedSet.getUpSet();
+    const int n = upSet.size();
+    const int nTasks = n * n;
     totalAttempts = 0;
+    validLayers.clear();
+
+    // One result buffer per task; concatenating them in task order reproduces
+    // the single-threaded order, so layer indices do not depend on nThreads
+    std::vector<std::vector<Layer>> taskLayers(nTasks);
+    std::atomic<long> layersFound{0};
+
+    // Progress like the search phases: attempts as the checked count, layers as found
+    ProgressReporter reporter(options, "layergen", nThreads, nTasks, "Tasks");
+    reporter.setFoundCounter([&layersFound]() { return layersFound.load(std::memory_order_relaxed); });
+    reporter.start();
 
     auto startTime = std::chrono::steady_clock::now();
-    backtrack(0, rows, usedMask);
+    WorkStealingPool pool(nThreads);
+    pool.run(nTasks, [&](int worker, int task) {
+        int first = task / n;
+        int second = task % n;
+        GenState state;
+        state.out = &taskLayers[task];
+
+        // Replay the first kSplitRows levels of the backtracking tree
+        if (first != second && canAddRow(state, upSet[first], 0)) {
+            uint8_t rows[8];
+            rows[0] = upSet[first];
+            updateCounts(state, rows[0], 1);
+            if (canAddRow(state, upSet[second], 1)) {
+                rows[1] = upSet[second];
+                updateCounts(state, rows[1], 1);
+                backtrack(state, kSplitRows, rows, (1ULL << first) | (1ULL << second));
+            }
+        }
+        totalAttempts += state.attempts;
+        layersFound += (long)state.out->size();
+        reporter.add(worker, (long)state.attempts, 1);
+    });
+    reporter.stop();
+
+    size_t total = 0;
+    for (const auto &layers : taskLayers) total += layers.size();
+    validLayers.reserve(total);
+    for (auto &layers : taskLayers) {
+        validLayers.insert(validLayers.end(), std::make_move_iterator(layers.begin()),
+                           std::make_move_iterator(layers.end()));
+    }
     auto endTime = std::chrono::steady_clock::now();
 
     auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(endTime - startTime).count();
-    std::cout << "\n[LayerGen] Complete! Found " << validLayers.size() << " valid layers" << std::endl;
-    std::cout << "[LayerGen] Time: " << elapsed << "s | Attempts: " << totalAttempts << std::endl;
+    std::cout << "[LayerGen] Complete! Found " << validLayers.size() << " valid layers" << std::endl;
+    std::cout << "[LayerGen] Time: " << elapsed << "s | Attempts: " << totalAttempts
+              << " | Threads: " << pool.getThreadCount() << std::endl;
+}
+
+uint64_t LayerGenerator::rulesFingerprint() const
+{
+    // FNV-1a over the rule inputs and the first two levels of the tree
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    auto mix = [&hash](uint64_t value) { hash = (hash ^ value) * 0x100000001B3ULL; };
+    mix(kRulesRevision);
+
+    const auto &upSet = balancedSet.getUpSet();
+    mix(upSet.size());
+    for (uint8_t row : upSet) {
+        mix(row);
+        mix(balancedSet.getComplement(row));
+    }
+    for (uint8_t first : upSet) {
+        GenState state;
+        bool firstOk = canAddRow(state, first, 0);
+        mix(firstOk);
+        if (!firstOk) continue;
+        updateCounts(state, first, 1);
+        uint64_t seconds = 0;
+        for (size_t i = 0; i < upSet.size(); ++i) {
+            if (canAddRow(state, upSet[i], 1)) seconds |= 1ULL << i;
+        }
+        mix(seconds);
+    }
+    return hash;
 }
 
-bool LayerGenerator::canAddRow(uint8_t row, int rowIdx)
+bool LayerGenerator::canAddRow(const GenState &state, uint8_t row, int rowIdx) const
 {
     // Check Z-axis constraint (column bits)
     for (int col = 0; col < 8; ++col) {
         int bit = (row >> (7 - col)) & 1;
-        int newCount = colCounts[col] + bit;
+        int newCount = state.colCounts[col] + bit;
 
         // Too many 1s in this column
         if (newCount > 4) return false;
@@ -48,7 +117,7 @@ bool LayerGenerator::canAddRow(uint8_t row, int rowIdx)
     // For each bit position in the byte, count how many 1s we'd have across all rows so far
     for (int bitPos = 0; bitPos < 8; ++bitPos) {
         int bit = (row >> bitPos) & 1;
-        int newCount = yAxisCounts[bitPos] + bit;
+        int newCount = state.yAxisCounts[bitPos] + bit;
 
         // Too many 1s in this Y-axis line
         if (newCount > 4) return false;
@@ -61,30 +130,24 @@ bool LayerGenerator::canAddRow(uint8_t row, int rowIdx)
     return true;
 }
 
-void LayerGenerator::updateCounts(uint8_t row, int delta)
+void LayerGenerator::updateCounts(GenState &state, uint8_t row, int delta)
 {
     // Update Z-axis (column) counts
     for (int col = 0; col < 8; ++col) {
         int bit = (row >> (7 - col)) & 1;
-        colCounts[col] += (bit * delta);
+        state.colCounts[col] += (bit * delta);
     }
 
     // Update Y-axis (bit position) counts
     for (int bitPos = 0; bitPos < 8; ++bitPos) {
         int bit = (row >> bitPos) & 1;
-        yAxisCounts[bitPos] += (bit * delta);
+        state.yAxisCounts[bitPos] += (bit * delta);
     }
 }
 
-void LayerGenerator::backtrack(int rowIdx, uint8_t currentRows[8], uint64_t usedMask)
+void LayerGenerator::backtrack(GenState &state, int rowIdx, uint8_t currentRows[8], uint64_t usedMask)
 {
-    totalAttempts++;
-
-    // Progress reporting every 100K attempts
-    if (totalAttempts % 100000 == 0) {
-        std::cout << "\r[LayerGen] Attempts: " << (totalAttempts / 1000000.0) << "M | Found: " << validLayers.size() <<
-                  std::flush;
-    }
+    state.attempts++;
 
     // Base case: first 4 rows done, add complements for last 4
     if (rowIdx == 4) {
@@ -135,15 +198,10 @@ void LayerGenerator::backtrack(int rowIdx, uint8_t currentRows[8], uint64_t used
 
         // All three axes validated! Create layer
         Layer L;
-        L.bitMatrix = 0;
         for (int i = 0; i < 4; ++i) L.numMask[i] = 0;
 
         for (int i = 0; i < 8; ++i) {
             L.rows[i] = currentRows[i];
-            L.uniqueNumbers.push_back(currentRows[i]);
-
-            // Build 64-bit matrix (each row is 8 bits)
-            L.bitMatrix |= (static_cast<uint64_t>(currentRows[i]) << (i * 8));
 
             // Build 256-bit number mask
             int bucket = currentRows[i] / 64;
@@ -151,7 +209,7 @@ void LayerGenerator::backtrack(int rowIdx, uint8_t currentRows[8], uint64_t used
             L.numMask[bucket] |= (1ULL << bit);
         }
 
-        validLayers.push_back(L);
+        state.out->push_back(L);
         return;
     }
 
@@ -165,16 +223,16 @@ void LayerGenerator::backtrack(int rowIdx, uint8_t currentRows[8], uint64_t used
         uint8_t candidate = upSet[i];
 
         // Check if this row can be added (both Z and Y axis constraints)
-        if (!canAddRow(candidate, rowIdx)) continue;
+        if (!canAddRow(state, candidate, rowIdx)) continue;
 
         // Add this row
         currentRows[rowIdx] = candidate;
-        updateCounts(candidate, 1);
+        updateCounts(state, candidate, 1);
 
         // Recurse
-        backtrack(rowIdx + 1, currentRows, usedMask | (1ULL << i));
+        backtrack(state, rowIdx + 1, currentRows, usedMask | (1ULL << i));
 
         // Backtrack
-        updateCounts(candidate, -1);
+        updateCounts(state, candidate, -1);
     }
 }
@@ -3,30 +3,57 @@
 
 #include "BalancedSet.h"
 #include "Layer.h"
+#include "SearchOptions.h"
+#include <atomic>
 #include <chrono>
 
 class LayerGenerator {
 public:
     LayerGenerator(const BalancedSet& bSet);
-    void generate();
+    
+    // Enumerate every valid layer on options.nThreads workers, with progress in
+    // options.progressFormat. The result order is the sequential backtracking
+    // order regardless of the thread count.
+    void generate(const SearchOptions& options);
     const std::vector<Layer>& getValidLayers() const { return validLayers; }
 
+    // Fingerprint of the generation rules over this up set, stored by
+    // LayerCache so a cache written under other rules is never reused. It
+    // hashes the up set order, the complement table and canAddRow's verdict
+    // on every two-row task seed; kRulesRevision stands for the rest of
+    // backtrack() and must be bumped whenever its output or order changes.
+    uint64_t rulesFingerprint() const;
+
 private:
+    // The benchmark suite (Benchmark.cpp) times the private kernels directly
+    friend struct BenchAccess;
+
     const BalancedSet& balancedSet;
     std::vector<Layer> validLayers;
 
-    // Z-axis: Column bit counters (vertical through layer)
-    int colCounts[8];
-    
-    // Y-axis: Bit position counters (same bit across all 8 rows)
-    int yAxisCounts[8];
+    // Backtracking state owned by one worker (one task at a time)
+    struct GenState {
+        // Z-axis: Column bit counters (vertical through layer)
+        int colCounts[8] = {0};
+        
+        // Y-axis: Bit position counters (same bit across all 8 rows)
+        int yAxisCounts[8] = {0};
+        
+        uint64_t attempts = 0;
+        std::vector<Layer>* out = nullptr;
+    };
     
+    static constexpr uint32_t kRulesRevision = 1;
+
+    // Tasks fix the first kSplitRows rows (one task per ordered pair of upSet indices)
+    static constexpr int kSplitRows = 2;
+
     // Statistics
-    uint64_t totalAttempts;
+    std::atomic<uint64_t> totalAttempts{0};
 
-    void backtrack(int rowIdx, uint8_t currentRows[8], uint64_t usedMask);
-    bool canAddRow(uint8_t row, int rowIdx);
-    void updateCounts(uint8_t row, int delta);
+    void backtrack(GenState& state, int rowIdx, uint8_t currentRows[8], uint64_t usedMask);
+    bool canAddRow(const GenState& state, uint8_t row, int rowIdx) const;
+    static void updateCounts(GenState& state, uint8_t row, int delta);
 };
 
 #endif
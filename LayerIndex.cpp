@@ -0,0 +1,44 @@
+#include "LayerIndex.h"
+#include <algorithm>
+
+void LayerIndex::build(const LayerStore& layers)
+{
+    const size_t n = layers.size();
+
+    // Counting sort by first row (ids stay ascending within a row)
+    rowStart.assign(257, 0);
+    for (size_t i = 0; i < n; ++i) rowStart[layers.rows(i)[0] + 1]++;
+    for (int r = 0; r < 256; ++r) rowStart[r + 1] += rowStart[r];
+    rowIds.resize(n);
+    std::vector<uint32_t> fill(rowStart.begin(), rowStart.end() - 1);
+    for (size_t i = 0; i < n; ++i) rowIds[fill[layers.rows(i)[0]]++] = (uint32_t)i;
+
+    view.layerCount = n;
+    view.rowStart = rowStart.data();
+    view.rowIds = rowIds.data();
+    buildSpans();
+}
+
+void LayerIndex::attach(const Arrays& external)
+{
+    rowStart.clear();
+    rowIds.clear();
+    view = external;
+    buildSpans();
+}
+
+void LayerIndex::buildSpans()
+{
+    spans.clear();
+    for (int r = 0; r < 256; ++r) {
+        Range bucket = withFirstRow((uint8_t)r);
+        if (bucket.empty()) continue;
+        // Ascending ids are consecutive exactly when first and last are size - 1 apart
+        if (bucket.last[-1] - bucket.first[0] != bucket.size() - 1) {
+            spans.clear();
+            return;
+        }
+        spans.push_back({bucket.first[0], bucket.last[-1] + 1, (uint8_t)r});
+    }
+    std::sort(spans.begin(), spans.end(), [](const Span& a, const Span& b) { return a.begin < b.begin; });
+}
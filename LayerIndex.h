@@ -0,0 +1,66 @@
+#ifndef LAYERINDEX_H
+#define LAYERINDEX_H
+
+#include "LayerStore.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Flat first-row table over a LayerStore: a CSR table of layer ids grouped
+// by their first row, ids ascending inside every bucket. LayerGenerator
+// emits layers first row by first row, so each bucket is also a run of
+// consecutive ids; rowSpans() lists those runs in id order, which lets the
+// assembler's levels drop every layer of an already used first row at once.
+class LayerIndex {
+public:
+    struct Range {
+        const uint32_t* first;
+        const uint32_t* last;
+        const uint32_t* begin() const { return first; }
+        const uint32_t* end() const { return last; }
+        size_t size() const { return last - first; }
+        bool empty() const { return first == last; }
+    };
+
+    // A first-row bucket as the id range [begin, end)
+    struct Span {
+        uint32_t begin, end;
+        uint8_t row;
+    };
+
+    // The raw arrays, for LayerCache to write and map back
+    struct Arrays {
+        size_t layerCount = 0;
+        const uint32_t* rowStart = nullptr;    // [257]
+        const uint32_t* rowIds = nullptr;      // [layerCount]
+    };
+
+    void build(const LayerStore& layers);
+
+    // Use arrays owned by someone else (a mapped LayerCache); they must outlive the index
+    void attach(const Arrays& external);
+    const Arrays& arrays() const { return view; }
+
+    // Layers whose first row equals row
+    Range withFirstRow(uint8_t row) const
+    {
+        return {view.rowIds + view.rowStart[row], view.rowIds + view.rowStart[row + 1]};
+    }
+
+    // Non-empty buckets in id order; empty when some bucket is not a run of
+    // consecutive ids (a store not grouped by first row)
+    const std::vector<Span>& rowSpans() const { return spans; }
+
+private:
+    // CSR by first row: rowIds[rowStart[r] .. rowStart[r + 1])
+    Arrays view;
+    std::vector<Span> spans;
+
+    // Storage behind view when the index was built here
+    std::vector<uint32_t> rowStart;
+    std::vector<uint32_t> rowIds;
+
+    void buildSpans();
+};
+
+#endif
@@ -0,0 +1,47 @@
+#include "LayerPrefixIndex.h"
+#include <cstring>
+
+void LayerPrefixIndex::build(const LayerStore& layers)
+{
+    const size_t n = layers.size();
+
+    // Deepest level first: a node's aggregates fold in its layers directly,
+    // and a parent's children are the runs that start inside it
+    for (int level = kLevels - 1; level >= 0; --level) {
+        std::vector<Node>& out = levels[level];
+        out.clear();
+        size_t child = 0;
+        for (size_t i = 0; i < n;) {
+            Node node;
+            node.begin = (uint32_t)i;
+            for (int w = 0; w < 4; ++w) {
+                node.andNumbers[w] = ~0ULL;
+                node.orNumbers[w] = 0;
+            }
+            const uint8_t* prefix = layers.rows(i);
+            for (; i < n && std::memcmp(layers.rows(i), prefix, level + 2) == 0; ++i) {
+                for (int w = 0; w < 4; ++w) {
+                    node.andNumbers[w] &= layers.numMask(i, w);
+                    node.orNumbers[w] |= layers.numMask(i, w);
+                }
+            }
+            node.end = (uint32_t)i;
+
+            node.firstChild = node.lastChild = 0;
+            if (level + 1 < kLevels) {
+                const std::vector<Node>& next = levels[level + 1];
+                node.firstChild = (uint32_t)child;
+                while (child < next.size() && next[child].begin < node.end) ++child;
+                node.lastChild = (uint32_t)child;
+            }
+            out.push_back(node);
+        }
+    }
+}
+
+size_t LayerPrefixIndex::footprint() const
+{
+    size_t total = 0;
+    for (const auto& level : levels) total += level.size() * sizeof(Node);
+    return total;
+}
@@ -0,0 +1,40 @@
+#ifndef LAYERPREFIXINDEX_H
+#define LAYERPREFIXINDEX_H
+
+#include "LayerStore.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Row-prefix trie over the ids of a LayerStore, for pruned scans of an id
+// range. LayerGenerator emits layers row by row, so the layers sharing their
+// first k rows are runs of consecutive ids: a node is one such run and its
+// children are the runs one row longer inside it. The one-row runs are
+// LayerIndex's first-row spans, so the trie starts at two rows. Each node
+// carries the AND and OR of its layers' number masks, so a scan can drop a
+// whole run when every layer in it collides, or take it unfiltered when none
+// can. Nodes of a level are stored flat, in id order.
+class LayerPrefixIndex {
+public:
+    static constexpr int kLevels = 2;   // Prefixes of 2 and 3 rows
+
+    struct Node {
+        uint32_t begin, end;             // Layer ids [begin, end)
+        uint32_t firstChild, lastChild;  // Nodes [firstChild, lastChild) of the next level
+        uint64_t andNumbers[4], orNumbers[4];
+    };
+
+    void build(const LayerStore& layers);
+
+    // Nodes of level (0 = two-row prefixes)
+    const Node* nodes(int level) const { return levels[level].data(); }
+    size_t nodeCount(int level) const { return levels[level].size(); }
+
+    // Bytes held by the nodes
+    size_t footprint() const;
+
+private:
+    std::vector<Node> levels[kLevels];
+};
+
+#endif
@@ -0,0 +1,60 @@
+#include "LayerStore.h"
+#include <cstring>
+
+void LayerStore::assign(const std::vector<Layer>& layers)
+{
+    release();
+    count = layers.size();
+    if (count == 0) return;
+
+    // Pad to whole groups of kPadding zeroed entries so vector kernels may
+    // load a full group past the last layer
+    size_t padded = paddedSize(count);
+    uint64_t* ownMasks[4];
+    for (int w = 0; w < 4; ++w) {
+        ownMasks[w] = allocate<uint64_t>(padded);
+        std::memset(ownMasks[w], 0, padded * sizeof(uint64_t));
+    }
+    uint8_t* ownRows = allocate<uint8_t>(padded * 8);
+    std::memset(ownRows, 0, padded * 8);
+
+    for (size_t i = 0; i < count; ++i) {
+        const Layer& layer = layers[i];
+        for (int w = 0; w < 4; ++w) {
+            ownMasks[w][i] = layer.numMask[w];
+        }
+        std::memcpy(ownRows + i * 8, layer.rows, 8);
+    }
+
+    owned = true;
+    for (int w = 0; w < 4; ++w) {
+        masks[w] = ownMasks[w];
+    }
+    rowData = ownRows;
+}
+
+void LayerStore::attach(size_t n, const uint64_t* const maskArrays[4], const uint8_t* rows)
+{
+    release();
+    count = n;
+    for (int w = 0; w < 4; ++w) {
+        masks[w] = maskArrays[w];
+    }
+    rowData = rows;
+}
+
+void LayerStore::release()
+{
+    if (owned) {
+        for (int w = 0; w < 4; ++w) {
+            deallocate(masks[w]);
+        }
+        deallocate(rowData);
+    }
+    owned = false;
+    for (int w = 0; w < 4; ++w) {
+        masks[w] = nullptr;
+    }
+    rowData = nullptr;
+    count = 0;
+}
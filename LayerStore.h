@@ -0,0 +1,65 @@
+#ifndef LAYERSTORE_H
+#define LAYERSTORE_H
+
+#include "Layer.h"
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+// Structure-of-arrays copy of a layer list for the assembler's hot loops.
+// Each field lives in its own contiguous, cache-line aligned array, so the
+// candidate filter, which only tests the number masks, touches 32 bytes per
+// layer instead of the whole Layer (and never follows a heap pointer).
+class LayerStore {
+public:
+    static constexpr size_t kAlignment = 64;
+    static constexpr size_t kPadding = 64;   // Arrays hold a multiple of this many entries
+
+    LayerStore() = default;
+    explicit LayerStore(const std::vector<Layer>& layers) { assign(layers); }
+    ~LayerStore() { release(); }
+
+    LayerStore(const LayerStore&) = delete;
+    LayerStore& operator=(const LayerStore&) = delete;
+
+    void assign(const std::vector<Layer>& layers);
+
+    // Use arrays owned by someone else (a mapped LayerCache); they must hold
+    // paddedSize(count) entries and outlive the store
+    void attach(size_t count, const uint64_t* const masks[4], const uint8_t* rows);
+
+    static size_t paddedSize(size_t count) { return (count + kPadding - 1) / kPadding * kPadding; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    // Word w (numbers 64w..64w+63) of the 256-bit used-number mask; stored
+    // as four planes so consecutive layers' words are adjacent
+    uint64_t numMask(size_t i, int w) const { return masks[w][i]; }
+    const uint64_t* numMaskPlane(int w) const { return masks[w]; }
+
+    const uint8_t* rows(size_t i) const { return rowData + i * 8; }
+
+    // Bytes held by the arrays (for the startup report)
+    size_t footprint() const { return count * (sizeof(uint64_t) * 4 + 8); }
+
+private:
+    size_t count = 0;
+    bool owned = false;
+    const uint64_t* masks[4] = {nullptr, nullptr, nullptr, nullptr};
+    const uint8_t* rowData = nullptr;
+
+    template <typename T>
+    static T* allocate(size_t n)
+    {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(kAlignment)));
+    }
+    static void deallocate(const void* p)
+    {
+        ::operator delete(const_cast<void*>(p), std::align_val_t(kAlignment));
+    }
+    void release();
+};
+
+#endif
@@ -0,0 +1,62 @@
+#include "MappedFile.h"
+#include <fstream>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    length = (size_t)st.st_size;
+    if (length > 0) {
+        void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            length = 0;
+            return false;
+        }
+        // Records are scanned front to back
+        madvise(p, length, MADV_SEQUENTIAL);
+        mapped = static_cast<const uint8_t*>(p);
+    }
+    ::close(fd);
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+    fallback.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    length = fallback.size();
+    mapped = fallback.empty() ? nullptr : fallback.data();
+#endif
+    opened = true;
+    return true;
+}
+
+void MappedFile::close()
+{
+#ifndef _WIN32
+    if (mapped != nullptr) {
+        munmap(const_cast<uint8_t*>(mapped), length);
+    }
+#endif
+    fallback.clear();
+    mapped = nullptr;
+    length = 0;
+    opened = false;
+}
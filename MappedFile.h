@@ -0,0 +1,32 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Read-only memory mapping of a whole file (mmap on POSIX; on other platforms
+// the file is read into memory so callers see the same pointer interface)
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    bool open(const std::string& path);
+    void close();
+    
+    const uint8_t* data() const { return mapped; }
+    size_t size() const { return length; }
+    bool isOpen() const { return opened; }
+    
+private:
+    const uint8_t* mapped{nullptr};
+    size_t length{0};
+    bool opened{false};
+    std::vector<uint8_t> fallback;  // Non-POSIX builds
+};
+
+#endif
@@ -0,0 +1,274 @@
+#include "MeetInMiddleSearch.h"
+#include "CubeTraits.h"
+#include "ProgressReporter.h"
+#include "ResultFile.h"
+#include "SearchTimer.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+namespace {
+// Halves per pool task in the build and join passes
+constexpr int kBlockSize = 256;
+}
+
+MeetInMiddleSearch::MeetInMiddleSearch(const BalancedSet& bSet)
+    : balancedSet(bSet)
+{
+    for (const ShiftSet& set : balancedSet.getFilteredShiftSets()) {
+        setMatrices.push_back(CubeTraits<8>::pack(set.values));
+    }
+}
+
+void MeetInMiddleSearch::enumerateHalves()
+{
+    // Every 4-subset of distinct sets in ascending index order (distinct sets
+    // have distinct bases, the same uniqueness rule as CubeSearcherV2)
+    const int numSets = setMatrices.size();
+    halves.clear();
+    for (int a = 0; a < numSets; ++a) {
+        for (int b = a + 1; b < numSets; ++b) {
+            for (int c = b + 1; c < numSets; ++c) {
+                for (int d = c + 1; d < numSets; ++d) {
+                    halves.push_back({(uint8_t)a, (uint8_t)b, (uint8_t)c, (uint8_t)d});
+                }
+            }
+        }
+    }
+}
+
+size_t MeetInMiddleSearch::shardOf(const Signature& sig) const
+{
+    uint64_t h = sig.planes[0] * 0x9E3779B97F4A7C15ULL;
+    h ^= sig.planes[1] + 0x632BE59BD9B4E019ULL + (h << 6) + (h >> 2);
+    h ^= sig.planes[2] + 0x94D049BB133111EBULL + (h << 6) + (h >> 2);
+    return (h * 0xBF58476D1CE4E5B9ULL) >> (64 - shardBits);
+}
+
+MeetInMiddleSearch::Signature MeetInMiddleSearch::complement(const Signature& sig)
+{
+    // Counts are 0..4; 4 - c maps 0->4, 1->3, 2->2, 3->1, 4->0:
+    // bit 0 unchanged, bit 1 flips where bit 0 is set, bit 2 set only for c = 0
+    Signature out;
+    out.planes[0] = sig.planes[0];
+    out.planes[1] = sig.planes[1] ^ sig.planes[0];
+    out.planes[2] = ~(sig.planes[0] | sig.planes[1] | sig.planes[2]);
+    return out;
+}
+
+void MeetInMiddleSearch::buildShards(int nThreads)
+{
+    const int numHalves = halves.size();
+    const int numBlocks = (numHalves + kBlockSize - 1) / kBlockSize;
+
+    // At least a few shards per thread so the merge pass balances
+    shardBits = 4;
+    while ((1 << shardBits) < 4 * nThreads) shardBits++;
+    const int numShards = 1 << shardBits;
+
+    signatures.assign(numHalves, Signature{});
+    std::vector<std::vector<std::vector<Entry>>> buckets(nThreads, std::vector<std::vector<Entry>>(numShards));
+
+    // Pass 1: each worker sums its halves' Z counts and buckets them by shard
+    WorkStealingPool pool(nThreads);
+    pool.run(numBlocks, [&](int worker, int block) {
+        const int end = std::min(numHalves, (block + 1) * kBlockSize);
+        for (int h = block * kBlockSize; h < end; ++h) {
+            uint64_t counts[3] = {0, 0, 0};
+            for (int layer = 0; layer < kHalfLayers; ++layer) {
+                uint64_t carry = setMatrices[halves[h][layer]];
+                for (int p = 0; p < 3; ++p) {
+                    uint64_t sum = counts[p] ^ carry;
+                    carry = counts[p] & carry;
+                    counts[p] = sum;
+                }
+            }
+            Signature& sig = signatures[h];
+            sig.planes[0] = counts[0];
+            sig.planes[1] = counts[1];
+            sig.planes[2] = counts[2];
+            buckets[worker][shardOf(sig)].push_back({sig, (uint32_t)h});
+        }
+    });
+
+    // Pass 2: each shard gathers its buckets and sorts them for equal_range lookups
+    shards.assign(numShards, {});
+    pool.run(numShards, [&](int, int s) {
+        std::vector<Entry>& shard = shards[s];
+        for (int w = 0; w < nThreads; ++w) {
+            shard.insert(shard.end(), buckets[w][s].begin(), buckets[w][s].end());
+        }
+        std::sort(shard.begin(), shard.end(), [](const Entry& x, const Entry& y) {
+            return x.sig < y.sig || (x.sig == y.sig && x.half < y.half);
+        });
+    });
+}
+
+long MeetInMiddleSearch::joinHalf(uint32_t half, bool findOnlyFirst, SearchProfile& localProfile)
+{
+    const std::array<uint8_t, kHalfLayers>& lower = halves[half];
+    const Signature want = complement(signatures[half]);
+    const std::vector<Entry>& shard = shards[shardOf(want)];
+
+    auto range = std::equal_range(shard.begin(), shard.end(), Entry{want, 0},
+                                  [](const Entry& x, const Entry& y) { return x.sig < y.sig; });
+    if (range.first == range.second) {
+        PBC_PROFILE_PRUNE(localProfile, kHalfLayers, PruneReason::MatrixMismatch, 1);
+        return 0;
+    }
+
+    // Canonical split: the lower half holds the 4 smallest set indices, so each
+    // unordered 8-subset is produced once and all 8 sets are distinct. Halves
+    // are numbered in lexicographic order and ties sort by number, so the
+    // partners starting after lower[3] form the tail of the range.
+    auto first = std::partition_point(range.first, range.second, [&](const Entry& e) {
+        return halves[e.half][0] <= lower[kHalfLayers - 1];
+    });
+    PBC_PROFILE_PRUNE(localProfile, kHalfLayers, PruneReason::Ordering, first - range.first);
+
+    long matched = 0;
+    const auto& shiftSets = balancedSet.getFilteredShiftSets();
+    for (auto it = first; it != range.second; ++it) {
+        if (stopRequested.load(std::memory_order_relaxed)) break;
+        const std::array<uint8_t, kHalfLayers>& upper = halves[it->half];
+        PBC_PROFILE_SOLUTION(localProfile);
+        matched++;
+
+        std::array<ShiftSet, 8> cube;
+        for (int z = 0; z < kHalfLayers; ++z) {
+            cube[z] = shiftSets[lower[z]];
+            cube[kHalfLayers + z] = shiftSets[upper[z]];
+        }
+
+        long id = ++foundCount;
+        if (id == 1) {
+            firstCubeData = cube;
+            firstCubeFound.store(true, std::memory_order_release);
+        }
+        uint8_t record[kSolutionRecordSize];
+        ResultFile::packCube(cube, record);
+        writer.submit(id, record);
+
+        if (findOnlyFirst) {
+            stopRequested = true;
+            break;
+        }
+    }
+    return matched;
+}
+
+void MeetInMiddleSearch::search(const SearchOptions& options)
+{
+    const int nThreads = std::max(1, options.nThreads);
+    const bool findOnlyFirst = options.findOnlyFirst;
+    foundCount = 0;
+    stopRequested = false;
+    firstCubeFound = false;
+    interrupted = false;
+    profile = SearchProfile();
+
+    auto startTime = std::chrono::steady_clock::now();
+    enumerateHalves();
+    buildShards(nThreads);
+    const int numHalves = halves.size();
+    auto buildTime = std::chrono::steady_clock::now();
+
+    size_t largestShard = 0;
+    for (const std::vector<Entry>& shard : shards) largestShard = std::max(largestShard, shard.size());
+
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "[PHASE 3] MEET-IN-THE-MIDDLE SEARCH" << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "[INFO] Mode: " << (findOnlyFirst ? "FIND FIRST ONLY" : "FIND ALL") << std::endl;
+    std::cout << "[INFO] Filtered shift sets: " << setMatrices.size() << std::endl;
+    std::cout << "[INFO] 4-layer halves: " << numHalves << " in " << shards.size()
+              << " signature shards (largest " << largestShard << ")" << std::endl;
+    std::cout << "[INFO] Table built in "
+              << std::chrono::duration<double, std::milli>(buildTime - startTime).count() << " ms" << std::endl;
+    std::cout << std::string(70, '=') << std::endl << std::endl;
+
+    writer.openTimestamped("[INFO]");
+    writer.openCompanion(options.outputFormat, "[INFO]");
+    writer.writeHeader({{"Mode", findOnlyFirst ? "FIND FIRST ONLY" : "FIND ALL"},
+                        {"Enumeration", std::string("MEET-IN-THE-MIDDLE") +
+                                            (options.expandOrderings ? " (expanded orderings)" : "")},
+                        {"Filtered shift sets", std::to_string(setMatrices.size())},
+                        {"4-layer halves", std::to_string(numHalves)}});
+    writer.start(options.expandOrderings, options.progressFormat);
+
+    const int numBlocks = (numHalves + kBlockSize - 1) / kBlockSize;
+    WorkStealingPool pool(nThreads);
+    std::atomic<int> processedHalves{0};
+    std::atomic<long> totalProbes{0};
+    std::vector<SearchProfile> workerProfiles(nThreads);
+
+    ProgressReporter reporter(options, "mitm", nThreads, numHalves, "Halves");
+    reporter.setFoundCounter([this]() { return foundCount.load(std::memory_order_relaxed); });
+    reporter.start();
+
+    // Time limit: raises the stop token
+    SearchTimer timer(options.timeLimitSeconds, [this, &pool]() {
+        interrupted = true;
+        stopRequested = true;
+        pool.requestStop();
+    });
+
+    pool.run(numBlocks, [&](int worker, int block) {
+        if (stopRequested.load(std::memory_order_relaxed)) {
+            pool.requestStop();
+            return;
+        }
+        SearchProfile& localProfile = workerProfiles[worker];
+        const int end = std::min(numHalves, (block + 1) * kBlockSize);
+        long probes = 0;
+        int done = 0;
+        for (int h = block * kBlockSize; h < end; ++h) {
+            if (stopRequested.load(std::memory_order_relaxed)) break;
+            PBC_PROFILE_NODE(localProfile, kHalfLayers);
+            joinHalf(h, findOnlyFirst, localProfile);
+            probes++;
+            done++;
+        }
+        totalProbes += probes;
+        processedHalves += done;
+        reporter.add(worker, probes, done);
+    });
+
+    timer.stop();
+    reporter.stop();
+    writer.finish();
+
+    for (const SearchProfile& p : workerProfiles) profile.merge(p);
+
+    auto endTime = std::chrono::steady_clock::now();
+    stats.engine = "mitm";
+    stats.threads = nThreads;
+    stats.seconds = std::chrono::duration<double>(endTime - startTime).count();
+    stats.pathsChecked = numHalves + totalProbes.load();
+    stats.cubesFound = foundCount.load();
+    stats.invalidCubes = writer.getInvalidCount();
+    stats.complete = processedHalves == numHalves && !stopRequested;
+
+    std::cout << "\n" << std::string(70, '=') << std::endl;
+    std::cout << (interrupted ? "[STOPPED] Time limit reached!" : "[COMPLETE] Search finished!") << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "[RESULT] Halves joined: " << processedHalves.load() << " / " << numHalves << std::endl;
+    std::cout << "[RESULT] Perfect cubes found: " << foundCount.load() << " (unordered layer sets)" << std::endl;
+    std::cout << "[RESULT] Ordered layer arrangements: " << getOrderedCubeCount() << std::endl;
+    if (writer.getInvalidCount() > 0) {
+        std::cout << "[RESULT] WARNING: " << writer.getInvalidCount() << " cube(s) failed verification" << std::endl;
+    }
+    std::cout << std::string(70, '=') << std::endl;
+
+    std::ostringstream totalTime;
+    totalTime << stats.seconds << "s";
+    writer.writeSummary(interrupted,
+                        {{"Total time", totalTime.str()},
+                         {"Halves joined", std::to_string(processedHalves.load()) + " / " + std::to_string(numHalves)},
+                         {"Perfect cubes found", std::to_string(foundCount.load())},
+                         {"Ordered layer arrangements", std::to_string(getOrderedCubeCount())}});
+    writer.close();
+}
@@ -0,0 +1,90 @@
+#ifndef MEETINMIDDLESEARCH_H
+#define MEETINMIDDLESEARCH_H
+
+#include "BalancedSet.h"
+#include "ResultWriter.h"
+#include "SearchOptions.h"
+#include "SearchProfile.h"
+#include "SearchStats.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Meet-in-the-middle engine for the shift-set cube (--engine=mitm).
+//
+// A cube is two halves of 4 distinct filtered shift sets whose per-cell Z
+// counts add up to exactly 4. Every 4-subset is enumerated once, its counts
+// are stored as a 192-bit bit-sliced signature in a hash-sharded table, and
+// each half is joined against the signature of "4 minus its counts". Taking
+// the lower half as the one whose sets all come first counts each unordered
+// cube exactly once, so the result equals CubeSearcherV2 --combinations
+// (times 8! for ordered layer arrangements) without walking depth 8.
+class MeetInMiddleSearch {
+public:
+    explicit MeetInMiddleSearch(const BalancedSet& bSet);
+
+    void search(const SearchOptions& options);
+
+    long getCubeCount() const { return foundCount; }
+    long getOrderedCubeCount() const { return foundCount * kLayerOrderings; }
+    bool wasInterrupted() const { return interrupted; }
+    const SearchStats& getStats() const { return stats; }
+    const SearchProfile& getProfile() const { return profile; }
+    const std::array<ShiftSet, 8>* getFirstCube() const { return firstCubeFound ? &firstCubeData : nullptr; }
+
+private:
+    static constexpr long kLayerOrderings = 40320;  // 8!
+    static constexpr int kHalfLayers = 4;
+
+    // Bit-sliced per-cell Z counts of one half (plane 0 = 1s, 1 = 2s, 2 = 4s)
+    struct Signature {
+        uint64_t planes[3];
+        bool operator==(const Signature& o) const
+        {
+            return planes[0] == o.planes[0] && planes[1] == o.planes[1] && planes[2] == o.planes[2];
+        }
+        bool operator<(const Signature& o) const
+        {
+            if (planes[0] != o.planes[0]) return planes[0] < o.planes[0];
+            if (planes[1] != o.planes[1]) return planes[1] < o.planes[1];
+            return planes[2] < o.planes[2];
+        }
+    };
+
+    struct Entry {
+        Signature sig;
+        uint32_t half;   // Index into halves
+    };
+
+    const BalancedSet& balancedSet;
+    std::vector<uint64_t> setMatrices;
+    std::vector<std::array<uint8_t, kHalfLayers>> halves;   // Ascending set indices
+    std::vector<Signature> signatures;                       // Parallel to halves
+
+    // Shard s holds the entries whose signature hashes to s, sorted by signature
+    std::vector<std::vector<Entry>> shards;
+    int shardBits{0};
+
+    ResultWriter writer;
+    std::atomic<long> foundCount{0};
+    std::atomic<bool> stopRequested{false};
+    std::atomic<bool> firstCubeFound{false};
+    bool interrupted{false};
+    std::array<ShiftSet, 8> firstCubeData;
+    SearchStats stats;
+    SearchProfile profile;
+
+    void enumerateHalves();
+    void buildShards(int nThreads);
+
+    size_t shardOf(const Signature& sig) const;
+
+    // Counts the other half must have: 4 - c per cell, in the same planes
+    static Signature complement(const Signature& sig);
+
+    // Join one half against the table; returns the number of matching cubes
+    long joinHalf(uint32_t half, bool findOnlyFirst, SearchProfile& localProfile);
+};
+
+#endif
@@ -0,0 +1,92 @@
+#include "ProgressReporter.h"
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+ProgressReporter::ProgressReporter(const SearchOptions& options, const std::string& engineName, int workers,
+                                   long total, const std::string& unit)
+    : format(options.progressFormat), intervalSeconds(std::max(1, options.progressInterval)),
+      engine(engineName), unitName(unit), nWorkers(std::max(1, workers)), totalUnits(total),
+      slots(new Slot[std::max(1, workers)]) {}
+
+ProgressReporter::~ProgressReporter()
+{
+    stop();
+}
+
+void ProgressReporter::setBaseline(long checked, long units)
+{
+    baseChecked = checked;
+    baseUnits = units;
+}
+
+void ProgressReporter::start()
+{
+    startTime = std::chrono::steady_clock::now();
+    if (format == ProgressFormat::None) return;
+
+    thread = std::thread([this]() {
+        std::unique_lock<std::mutex> lock(stopMtx);
+        while (!stopCv.wait_for(lock, std::chrono::seconds(intervalSeconds), [this]() { return stopping; })) {
+            report(false);
+        }
+    });
+}
+
+void ProgressReporter::stop()
+{
+    if (!thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(stopMtx);
+        stopping = true;
+    }
+    stopCv.notify_all();
+    thread.join();
+    report(true);
+}
+
+void ProgressReporter::report(bool final)
+{
+    long checked = baseChecked;
+    long units = baseUnits;
+    for (int w = 0; w < nWorkers; ++w) {
+        checked += slots[w].checked.load(std::memory_order_relaxed);
+        units += slots[w].units.load(std::memory_order_relaxed);
+    }
+    long found = foundCounter ? foundCounter() : 0;
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    double fraction = totalUnits > 0 ? (double)units / totalUnits : 0;
+    double rate = elapsed > 0 ? checked / elapsed : 0;
+    double eta = (fraction > 0.001 && fraction < 1) ? elapsed * (1 - fraction) / fraction : 0;
+
+    // Build the whole line first: one write per sample
+    std::ostringstream line;
+    if (format == ProgressFormat::Json) {
+        line << std::fixed << std::setprecision(3)
+             << "{\"type\":\"progress\",\"engine\":\"" << engine << "\""
+             << ",\"elapsed\":" << elapsed
+             << ",\"done\":" << units << ",\"total\":" << totalUnits << ",\"unit\":\"" << unitName << "\""
+             << ",\"percent\":" << fraction * 100.0
+             << ",\"checked\":" << checked
+             << ",\"rate\":" << std::setprecision(0) << rate
+             << ",\"found\":" << found
+             << ",\"eta\":" << eta
+             << ",\"final\":" << (final ? "true" : "false") << "}\n";
+    } else {
+        long secs = (long)elapsed;
+        line << "\r[PROGRESS] " << std::fixed << std::setprecision(2) << fraction * 100.0 << "%"
+             << " | " << unitName << ": " << units << "/" << totalUnits
+             << " | Checked: " << std::scientific << (double)checked
+             << std::fixed << " | Speed: " << rate / 1000000.0 << "M/s"
+             << " | Found: " << found
+             << " | Elapsed: " << std::setfill('0') << std::setw(2) << secs / 3600 << ":"
+             << std::setw(2) << (secs % 3600) / 60 << ":" << std::setw(2) << secs % 60;
+        if (eta > 0) {
+            long etaSecs = (long)eta;
+            line << " | ETA: " << etaSecs / 3600 << "h " << (etaSecs % 3600) / 60 << "m " << etaSecs % 60 << "s";
+        }
+        if (final) line << "\n";
+    }
+    std::cout << line.str() << std::flush;
+}
@@ -0,0 +1,73 @@
+#ifndef PROGRESSREPORTER_H
+#define PROGRESSREPORTER_H
+
+#include "SearchOptions.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Owns all progress output of a search. Workers only bump their own relaxed
+// counters; one reporter thread sums them every interval and prints either the
+// human status line or one JSON object per line (--progress=json).
+class ProgressReporter {
+public:
+    // totalUnits: work items of the run (tasks or root layers), unitName labels them
+    ProgressReporter(const SearchOptions& options, const std::string& engine, int nWorkers,
+                     long totalUnits, const std::string& unitName);
+    ~ProgressReporter();
+
+    ProgressReporter(const ProgressReporter&) = delete;
+    ProgressReporter& operator=(const ProgressReporter&) = delete;
+
+    // Work finished by earlier segments of a resumed run
+    void setBaseline(long checked, long units);
+
+    // Sampled by the reporter for the "found" field
+    void setFoundCounter(std::function<long()> counter) { foundCounter = std::move(counter); }
+
+    void start();
+
+    // Print the final sample and join the reporter thread (idempotent)
+    void stop();
+
+    // Worker side: only worker `worker` writes its slot, so no read-modify-write is needed
+    void add(int worker, long checked, long units)
+    {
+        Slot& slot = slots[worker];
+        slot.checked.store(slot.checked.load(std::memory_order_relaxed) + checked, std::memory_order_relaxed);
+        slot.units.store(slot.units.load(std::memory_order_relaxed) + units, std::memory_order_relaxed);
+    }
+
+private:
+    // One cache line per worker so the counters never share a line
+    struct alignas(64) Slot {
+        std::atomic<long> checked{0};
+        std::atomic<long> units{0};
+    };
+
+    ProgressFormat format;
+    int intervalSeconds;
+    std::string engine;
+    std::string unitName;
+    int nWorkers;
+    long totalUnits;
+    long baseChecked{0};
+    long baseUnits{0};
+    std::unique_ptr<Slot[]> slots;
+    std::function<long()> foundCounter;
+
+    std::chrono::steady_clock::time_point startTime;
+    std::thread thread;
+    std::mutex stopMtx;
+    std::condition_variable stopCv;
+    bool stopping{false};
+
+    void report(bool final);
+};
+
+#endif
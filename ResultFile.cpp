@@ -0,0 +1,189 @@
+#include "ResultFile.h"
+#include "CubeVerifier.h"
+#include "SolutionFile.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+bool startsWith(const std::string& line, const std::string& prefix)
+{
+    return line.compare(0, prefix.size(), prefix) == 0;
+}
+
+}
+
+bool ResultFile::read(const std::string& path, ResultFileSummary& summary,
+                      const std::function<void(const StoredSolution&)>& onSolution)
+{
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        std::cout << "[ResultFile] ERROR: Cannot open " << path << std::endl;
+        return false;
+    }
+    
+    summary = ResultFileSummary();
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        lineNo++;
+        if (startsWith(line, "Mode: ")) {
+            summary.mode = line.substr(6);
+        } else if (startsWith(line, "Enumeration: ")) {
+            summary.enumeration = line.substr(13);
+        } else if (startsWith(line, "Shard: ")) {
+            if (std::sscanf(line.c_str(), "Shard: %d/%d", &summary.shardIndex, &summary.shardCount) != 2) {
+                std::cout << "[ResultFile] ERROR: " << path << ":" << lineNo << ": bad shard line" << std::endl;
+                return false;
+            }
+        } else if (startsWith(line, "Binary solutions: ")) {
+            summary.binaryPath = line.substr(18);
+        } else if (startsWith(line, "FINAL RESULTS")) {
+            summary.hasSummary = true;
+            summary.finished = true;
+        } else if (startsWith(line, "PARTIAL RESULTS")) {
+            summary.hasSummary = true;
+        } else if (summary.hasSummary && startsWith(line, "Total permutations checked: ")) {
+            std::sscanf(line.c_str(), "Total permutations checked: %ld / %ld",
+                        &summary.checkedPaths, &summary.totalPermutations);
+        } else if (summary.hasSummary && startsWith(line, "Perfect cubes found: ")) {
+            summary.foundCubes = std::stol(line.substr(21));
+        } else if (startsWith(line, "SOLUTION #")) {
+            StoredSolution solution;
+            solution.id = std::atol(line.c_str() + 10);
+            
+            // Separator, then one "Set i (base: b): v0 ... v7" line per layer
+            std::getline(in, line);
+            lineNo++;
+            for (int layer = 0; layer < 8; ++layer) {
+                int idx, base, v[8];
+                if (!std::getline(in, line) ||
+                    std::sscanf(line.c_str(), "Set %d (base: %d): %d %d %d %d %d %d %d %d",
+                                &idx, &base, &v[0], &v[1], &v[2], &v[3],
+                                &v[4], &v[5], &v[6], &v[7]) != 10 || idx != layer) {
+                    std::cout << "[ResultFile] ERROR: " << path << ":" << lineNo + 1
+                              << ": malformed solution #" << solution.id << std::endl;
+                    return false;
+                }
+                lineNo++;
+                solution.layers[layer].base = (uint8_t)base;
+                for (int j = 0; j < 8; ++j) {
+                    solution.layers[layer].values[j] = (uint8_t)v[j];
+                }
+            }
+            summary.solutionBlocks++;
+            onSolution(solution);
+        }
+    }
+    
+    if (!summary.binaryPath.empty()) {
+        // Binary paths are written relative to the text file's directory
+        std::string binaryPath = summary.binaryPath;
+        size_t slash = path.find_last_of('/');
+        if (binaryPath[0] != '/' && slash != std::string::npos) {
+            binaryPath = path.substr(0, slash + 1) + binaryPath;
+        }
+        
+        SolutionFileReader reader;
+        if (!reader.open(binaryPath)) return false;
+        StoredSolution solution;
+        reader.forEach([&](const uint8_t* cube) {
+            solution.id++;
+            solution.layers = unpackCube(cube);
+            summary.solutionBlocks++;
+            onSolution(solution);
+            return true;
+        });
+    }
+    return true;
+}
+
+bool ResultFile::isPerfectCube(const std::array<ShiftSet, 8>& layers)
+{
+    return CubeVerifier::check(layers).perfect();
+}
+
+void ResultFile::writeSolutionBlock(std::ostream& out, const std::array<ShiftSet, 8>& layers,
+                                    const std::string& label)
+{
+    out << "\n================================================\n";
+    out << label << "\n";
+    out << "================================================\n";
+    
+    for (int i = 0; i < 8; ++i) {
+        out << "Set " << i << " (base: " << (int)layers[i].base << "): ";
+        for (int j = 0; j < 8; ++j) {
+            out << (int)layers[i].values[j];
+            if (j < 7) out << " ";
+        }
+        out << "\n";
+    }
+    
+    out << "================================================\n";
+}
+
+void ResultFile::packCube(const std::array<ShiftSet, 8>& layers, uint8_t record[64])
+{
+    for (int z = 0; z < 8; ++z) {
+        for (int row = 0; row < 8; ++row) {
+            record[z * 8 + row] = layers[z].values[row];
+        }
+    }
+}
+
+std::array<ShiftSet, 8> ResultFile::unpackCube(const uint8_t record[64])
+{
+    std::array<ShiftSet, 8> layers;
+    for (int z = 0; z < 8; ++z) {
+        for (int row = 0; row < 8; ++row) {
+            layers[z].values[row] = record[z * 8 + row];
+        }
+        layers[z].base = layers[z].values[0];
+    }
+    return layers;
+}
+
+bool ResultFile::convertBinaryToText(const std::string& binaryPath, const std::string& textPath)
+{
+    SolutionFileReader reader;
+    if (!reader.open(binaryPath)) return false;
+    
+    std::ofstream out(textPath);
+    if (!out.is_open()) {
+        std::cout << "[ResultFile] ERROR: Cannot create " << textPath << std::endl;
+        return false;
+    }
+    
+    out << "================================================\n";
+    out << "Perfect Bit Cube Search Results\n";
+    out << "Converted from: " << binaryPath << "\n";
+    out << "================================================\n\n";
+    
+    long id = 0;
+    reader.forEach([&](const uint8_t* cube) {
+        writeSolutionBlock(out, unpackCube(cube), "SOLUTION #" + std::to_string(++id));
+        return true;
+    });
+    
+    std::cout << "[ResultFile] Converted " << id << " solutions from " << binaryPath
+              << " to " << textPath << std::endl;
+    return true;
+}
+
+std::string ResultFile::cubeKey(const std::array<ShiftSet, 8>& layers, bool orderInvariant)
+{
+    std::array<std::string, 8> rows;
+    for (int z = 0; z < 8; ++z) {
+        rows[z].assign(layers[z].values.begin(), layers[z].values.end());
+    }
+    if (orderInvariant) std::sort(rows.begin(), rows.end());
+    
+    std::string key;
+    key.reserve(64);
+    for (const std::string& r : rows) key += r;
+    return key;
+}
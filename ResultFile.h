@@ -0,0 +1,60 @@
+#ifndef RESULTFILE_H
+#define RESULTFILE_H
+
+#include "BalancedSet.h"
+#include <array>
+#include <functional>
+#include <ostream>
+#include <string>
+
+// One solution block of a PerfectCube_Results_*.txt file
+struct StoredSolution {
+    long id{0};
+    std::array<ShiftSet, 8> layers;
+};
+
+// Header and summary fields of a result file
+struct ResultFileSummary {
+    std::string mode;           // "FIND ALL" / "FIND FIRST ONLY"
+    std::string enumeration;    // "PERMUTATIONS" / "COMBINATIONS" (+ expansion note)
+    int shardIndex{0};
+    int shardCount{1};
+    bool hasSummary{false};     // FINAL/PARTIAL RESULTS block present
+    bool finished{false};       // FINAL RESULTS (the run covered its whole shard)
+    long checkedPaths{0};       // Cumulative over resumed segments
+    long totalPermutations{0};
+    long foundCubes{0};         // Cumulative over resumed segments
+    long solutionBlocks{0};     // SOLUTION blocks actually present in the file
+    std::string binaryPath;     // Companion .bin file holding the solutions, if any
+};
+
+// Reader/writer helpers for the text result format written by CubeSearcherV2.
+// With --format=binary the text file keeps the header and summary and names a
+// companion SolutionFile (.bin) that holds the solutions.
+class ResultFile {
+public:
+    // Parse a result file, calling onSolution for every solution (text blocks
+    // or records of the companion binary file)
+    static bool read(const std::string& path, ResultFileSummary& summary,
+                     const std::function<void(const StoredSolution&)>& onSolution);
+    
+    // Full X/Y/Z balance check of a stored cube (file contents are untrusted)
+    static bool isPerfectCube(const std::array<ShiftSet, 8>& layers);
+    
+    // Key identifying a cube: its 64 bytes, with layers sorted when layer order
+    // does not matter (combination runs)
+    static std::string cubeKey(const std::array<ShiftSet, 8>& layers, bool orderInvariant);
+    
+    // Write one "SOLUTION" block in the text format
+    static void writeSolutionBlock(std::ostream& out, const std::array<ShiftSet, 8>& layers,
+                                   const std::string& label);
+    
+    // Convert between shift-set layers and 64-byte binary records
+    static void packCube(const std::array<ShiftSet, 8>& layers, uint8_t record[64]);
+    static std::array<ShiftSet, 8> unpackCube(const uint8_t record[64]);
+    
+    // Write a binary solution file in the text format (SOLUTION #1..#n)
+    static bool convertBinaryToText(const std::string& binaryPath, const std::string& textPath);
+};
+
+#endif
@@ -0,0 +1,162 @@
+#include "ResultMerger.h"
+#include "ResultFile.h"
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <unordered_set>
+
+namespace {
+
+// Stats of one shard; resumed segments carry cumulative counters, so keep the
+// segment that got furthest
+struct ShardStats {
+    bool finished{false};
+    long checkedPaths{0};
+    long foundCubes{0};
+    int segments{0};
+};
+
+}
+
+int ResultMerger::merge(const std::string& outputPath, const std::vector<std::string>& inputPaths)
+{
+    std::cout << "[MERGE] Combining " << inputPaths.size() << " result file(s) into " << outputPath << std::endl;
+    
+    std::ofstream out(outputPath);
+    if (!out.is_open()) {
+        std::cout << "[MERGE] ERROR: Cannot create " << outputPath << std::endl;
+        return 1;
+    }
+    
+    std::string mode, enumeration;
+    int shardCount = 0;
+    long totalPermutations = 0;
+    bool consistent = true;
+    std::map<int, ShardStats> shards;
+    std::unordered_set<std::string> seen;
+    std::unordered_set<std::string> distinct;
+    long solutionBlocks = 0, duplicates = 0, invalid = 0;
+    long mergedId = 0;
+    bool headerWritten = false;
+    
+    auto writeHeader = [&](const std::string& runMode, const std::string& runEnumeration) {
+        out << "================================================\n";
+        out << "Perfect Bit Cube Search Results (merged)\n";
+        out << "Mode: " << runMode << "\n";
+        out << "Enumeration: " << runEnumeration << "\n";
+        out << "Shard: 0/1\n";
+        out << "================================================\n\n";
+        headerWritten = true;
+    };
+    
+    for (const std::string& path : inputPaths) {
+        ResultFileSummary summary;
+        
+        // The header precedes all solutions, so write ours on the first solution
+        auto onSolution = [&](const StoredSolution& solution) {
+            if (!headerWritten) writeHeader(summary.mode, summary.enumeration);
+            if (!ResultFile::isPerfectCube(solution.layers)) {
+                invalid++;
+                std::cout << "[MERGE] WARNING: " << path << ": solution #" << solution.id
+                          << " fails X/Y/Z verification, dropped" << std::endl;
+                return;
+            }
+            if (!seen.insert(ResultFile::cubeKey(solution.layers, false)).second) {
+                duplicates++;
+                return;
+            }
+            
+            // Count cubes the way the searcher does: expanded orderings write 8!
+            // blocks per combination, so combinations count distinct layer sets
+            bool combinationRun = summary.enumeration.compare(0, 12, "COMBINATIONS") == 0;
+            distinct.insert(ResultFile::cubeKey(solution.layers, combinationRun));
+            
+            ResultFile::writeSolutionBlock(out, solution.layers, "SOLUTION #" + std::to_string(++mergedId));
+        };
+        
+        if (!ResultFile::read(path, summary, onSolution)) return 1;
+        solutionBlocks += summary.solutionBlocks;
+        
+        // All inputs must come from the same search split the same way
+        if (shardCount == 0) {
+            mode = summary.mode;
+            enumeration = summary.enumeration;
+            shardCount = summary.shardCount;
+        } else if (summary.mode != mode || summary.enumeration != enumeration ||
+                   summary.shardCount != shardCount) {
+            std::cout << "[MERGE] ERROR: " << path << " comes from a different search ("
+                      << summary.mode << ", " << summary.enumeration << ", "
+                      << summary.shardCount << " shards)" << std::endl;
+            consistent = false;
+        }
+        if (summary.hasSummary && summary.totalPermutations > 0) {
+            totalPermutations = summary.totalPermutations;
+        }
+        
+        ShardStats& stats = shards[summary.shardIndex];
+        stats.segments++;
+        if (summary.hasSummary && summary.checkedPaths >= stats.checkedPaths) {
+            stats.checkedPaths = summary.checkedPaths;
+            stats.foundCubes = summary.foundCubes;
+            stats.finished = stats.finished || summary.finished;
+        }
+        
+        std::cout << "[MERGE] " << path << ": shard " << summary.shardIndex << "/" << summary.shardCount
+                  << ", " << summary.solutionBlocks << " solution blocks"
+                  << (summary.finished ? "" : " (partial)") << std::endl;
+    }
+    
+    // Shard coverage: every shard present and finished exactly as split
+    long checkedPaths = 0;
+    long reportedCubes = 0;
+    for (int i = 0; i < shardCount; ++i) {
+        auto it = shards.find(i);
+        if (it == shards.end()) {
+            std::cout << "[MERGE] ERROR: shard " << i << "/" << shardCount << " is missing" << std::endl;
+            consistent = false;
+            continue;
+        }
+        if (!it->second.finished) {
+            std::cout << "[MERGE] ERROR: shard " << i << "/" << shardCount
+                      << " has no FINAL RESULTS (resume it first)" << std::endl;
+            consistent = false;
+        }
+        checkedPaths += it->second.checkedPaths;
+        reportedCubes += it->second.foundCubes;
+    }
+    if ((int)shards.size() > shardCount) {
+        std::cout << "[MERGE] ERROR: shard index out of range for " << shardCount << " shards" << std::endl;
+        consistent = false;
+    }
+    
+    long uniqueCubes = distinct.size();
+    if (uniqueCubes != reportedCubes) {
+        std::cout << "[MERGE] ERROR: shards report " << reportedCubes << " cubes but "
+                  << uniqueCubes << " distinct verified cubes were found" << std::endl;
+        consistent = false;
+    }
+    
+    if (!headerWritten) writeHeader(mode, enumeration);
+    
+    out << "\n================================================\n";
+    out << (consistent ? "FINAL RESULTS\n" : "PARTIAL RESULTS (merge incomplete)\n");
+    out << "================================================\n";
+    out << "Merged shards: " << shards.size() << " / " << shardCount << "\n";
+    out << "Total permutations checked: " << checkedPaths << " / " << totalPermutations << "\n";
+    out << "Perfect cubes found: " << uniqueCubes << "\n";
+    out << "================================================\n";
+    out.close();
+    
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "[MERGE] Shards merged: " << shards.size() << " / " << shardCount << std::endl;
+    std::cout << "[MERGE] Solution blocks read: " << solutionBlocks << std::endl;
+    std::cout << "[MERGE] Duplicates dropped: " << duplicates << std::endl;
+    std::cout << "[MERGE] Invalid cubes dropped: " << invalid << std::endl;
+    std::cout << "[MERGE] Total permutations checked: " << checkedPaths << std::endl;
+    std::cout << "[MERGE] Perfect cubes found: " << uniqueCubes << std::endl;
+    std::cout << (consistent ? "[MERGE] ✓ Verified total" : "[MERGE] ✗ Merge is incomplete or inconsistent")
+              << std::endl;
+    std::cout << std::string(70, '=') << std::endl;
+    
+    return (consistent && invalid == 0) ? 0 : 1;
+}
@@ -0,0 +1,16 @@
+#ifndef RESULTMERGER_H
+#define RESULTMERGER_H
+
+#include <string>
+#include <vector>
+
+// Combines the result files of a sharded (and possibly resumed) search into one
+// file: every solution is re-verified and deduplicated, shard coverage and the
+// per-shard counters are checked, and the totals are written as FINAL RESULTS.
+class ResultMerger {
+public:
+    // Returns 0 if the merged total is complete and consistent
+    static int merge(const std::string& outputPath, const std::vector<std::string>& inputPaths);
+};
+
+#endif
@@ -0,0 +1,291 @@
+#include "ResultWriter.h"
+#include "ResultFile.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr size_t kWriteBatch = 256;   // Solutions written per flush
+constexpr long kLayerOrderings = 40320;  // 8!
+
+}
+
+ResultWriter::ResultWriter(size_t capacity)
+{
+    // Round up to a power of two so positions map to slots with a mask
+    size_t size = 2;
+    while (size < capacity) size <<= 1;
+    slots.reset(new Slot[size]);
+    mask = size - 1;
+    for (size_t i = 0; i < size; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+ResultWriter::~ResultWriter()
+{
+    close();
+}
+
+bool ResultWriter::open(const std::string& path)
+{
+    textPath = path;
+    textFile.open(path, std::ios::app);
+    return textFile.is_open();
+}
+
+bool ResultWriter::openBinary(const std::string& path, bool delta)
+{
+    binaryPath = path;
+    return binaryFile.open(path, delta);
+}
+
+bool ResultWriter::openTimestamped(const std::string& tag)
+{
+    std::string path = timestampedPath("PerfectCube_Results_", ".txt");
+    if (!open(path)) return false;
+    std::cout << tag << " Results will be saved to: " << path << std::endl;
+    return true;
+}
+
+void ResultWriter::openCompanion(OutputFormat format, const std::string& tag)
+{
+    if (format == OutputFormat::Text) return;
+
+    // Next to the text results: PerfectCube_Results_<time>.bin
+    const bool delta = format == OutputFormat::BinaryDelta;
+    std::string path = textPath.substr(0, textPath.size() - 4) + ".bin";
+    if (openBinary(path, delta)) {
+        std::cout << tag << " Solutions will be saved to: " << path
+                  << (delta ? " (binary, delta-compressed)" : " (binary)") << std::endl;
+    } else {
+        std::cout << "[ResultWriter] WARNING: Cannot create " << path << ", falling back to text output"
+                  << std::endl;
+    }
+}
+
+void ResultWriter::writeHeader(const Fields& fields)
+{
+    textFile << "================================================\n";
+    textFile << "Perfect Bit Cube Search Results\n";
+    for (const auto& field : fields) {
+        textFile << field.first << ": " << field.second << "\n";
+    }
+    textFile << "Start time: " << std::chrono::system_clock::now().time_since_epoch().count() << "\n";
+    if (isBinary()) {
+        textFile << "Binary solutions: " << binaryPath << "\n";
+    }
+    textFile << "================================================\n\n";
+    textFile.flush();
+}
+
+void ResultWriter::writeSummary(bool interrupted, const Fields& fields)
+{
+    textFile << "\n================================================\n";
+    textFile << (interrupted ? "PARTIAL RESULTS (time limit)\n" : "FINAL RESULTS\n");
+    textFile << "================================================\n";
+    for (const auto& field : fields) {
+        textFile << field.first << ": " << field.second << "\n";
+    }
+    textFile << "================================================\n";
+    textFile.flush();
+}
+
+std::string ResultWriter::timestampedPath(const std::string& prefix, const std::string& extension)
+{
+    auto now = std::chrono::system_clock::now();
+    auto time_t = std::chrono::system_clock::to_time_t(now);
+    
+    std::stringstream ss;
+    ss << prefix << std::put_time(std::localtime(&time_t), "%Y%m%d_%H%M%S") << extension;
+    return ss.str();
+}
+
+void ResultWriter::start(bool expand, ProgressFormat progress, bool announceAll)
+{
+    if (writerThread.joinable()) return;
+    expandOrderings = expand;
+    announceEach = announceAll;
+    announcedFirst = false;
+    messages = progress == ProgressFormat::Json ? &std::cerr : &std::cout;
+    stopping = false;
+    writerThread = std::thread(&ResultWriter::writerLoop, this);
+}
+
+bool ResultWriter::tryPush(const PendingSolution& item)
+{
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = slots[pos & mask];
+        size_t seq = slot.sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.item = item;
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;  // Full
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool ResultWriter::tryPop(PendingSolution& item)
+{
+    Slot& slot = slots[dequeuePos & mask];
+    size_t seq = slot.sequence.load(std::memory_order_acquire);
+    if (seq != dequeuePos + 1) return false;  // Empty (or producer still copying)
+    
+    item = slot.item;
+    slot.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+    dequeuePos++;
+    return true;
+}
+
+void ResultWriter::submit(long id, const uint8_t cube[kSolutionRecordSize])
+{
+    PendingSolution item;
+    item.id = id;
+    std::memcpy(item.cube, cube, kSolutionRecordSize);
+    
+    // Backpressure: wait for the writer instead of growing without bound
+    if (!tryPush(item)) {
+        stallCount++;
+        while (!tryPush(item)) {
+            std::this_thread::yield();
+        }
+    }
+    submittedCount++;
+}
+
+void ResultWriter::writerLoop()
+{
+    PendingSolution item;
+    int idleRounds = 0;
+    for (;;) {
+        size_t batch = 0;
+        while (batch < kWriteBatch && tryPop(item)) {
+            writeSolution(item);
+            batch++;
+        }
+        
+        if (batch > 0) {
+            if (binaryFile.isOpen()) binaryFile.flush();
+            else textFile.flush();
+            processedCount += batch;
+            idleRounds = 0;
+            continue;
+        }
+        
+        if (stopping && processedCount == submittedCount) break;
+        
+        // Idle: back off from spinning to short sleeps
+        if (++idleRounds < 64) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    }
+}
+
+void ResultWriter::writeSolution(const PendingSolution& item)
+{
+    if (!ResultFile::isPerfectCube(ResultFile::unpackCube(item.cube))) {
+        invalidCount++;
+        *messages << "\n⚠️  WARNING: Cube #" << item.id << " FAILED verification, not saved!" << std::endl;
+        return;
+    }
+    
+    if (!expandOrderings) {
+        writeRecord(item.id, item.cube, 0);
+    } else {
+        // Every layer ordering of a valid cube is valid: permute the 8-byte layers
+        std::array<int, 8> order = {0, 1, 2, 3, 4, 5, 6, 7};
+        uint8_t ordered[kSolutionRecordSize];
+        long orderingIdx = 0;
+        do {
+            for (int z = 0; z < 8; ++z) {
+                std::memcpy(ordered + z * 8, item.cube + order[z] * 8, 8);
+            }
+            writeRecord(item.id, ordered, ++orderingIdx);
+        } while (std::next_permutation(order.begin(), order.end()));
+    }
+    
+    if (announceEach || !announcedFirst) {
+        *messages << "\n[FOUND!] Perfect Cube #" << item.id << " discovered!\n";
+        if (!announceEach) *messages << "[INFO] Further cubes go to the results file without a message\n";
+        announcedFirst = true;
+    }
+}
+
+void ResultWriter::writeRecord(long id, const uint8_t cube[kSolutionRecordSize], long orderingIdx)
+{
+    if (binaryFile.isOpen()) {
+        binaryFile.append(cube);
+        return;
+    }
+    
+    std::string label = "SOLUTION #" + std::to_string(id);
+    if (orderingIdx > 0) {
+        label += " (ordering " + std::to_string(orderingIdx) + "/" + std::to_string(kLayerOrderings) + ")";
+    }
+    ResultFile::writeSolutionBlock(textFile, ResultFile::unpackCube(cube), label);
+}
+
+void ResultWriter::flush()
+{
+    if (!writerThread.joinable()) {
+        textFile.flush();
+        binaryFile.flush();
+        return;
+    }
+    long target = submittedCount;
+    while (processedCount < target) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+void ResultWriter::sync()
+{
+    flush();
+    binaryFile.sync();
+#ifndef _WIN32
+    // std::ofstream has no descriptor; fsync on another one syncs the same file
+    if (textPath.empty()) return;
+    int fd = ::open(textPath.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        ::close(fd);
+    }
+#endif
+}
+
+void ResultWriter::finish()
+{
+    if (!writerThread.joinable()) return;
+    stopping = true;
+    writerThread.join();
+    textFile.flush();
+}
+
+void ResultWriter::close()
+{
+    finish();
+    binaryFile.close();
+    if (textFile.is_open()) {
+        textFile.close();
+    }
+}
@@ -0,0 +1,127 @@
+#ifndef RESULTWRITER_H
+#define RESULTWRITER_H
+
+#include "SearchOptions.h"
+#include "SolutionFile.h"
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Asynchronous result writer shared by the search engines.
+//
+// Search threads submit found cubes into a bounded lock-free MPSC ring buffer;
+// one writer thread drains it in batches, verifies every cube (X/Y/Z), expands
+// layer orderings if requested, writes text blocks or binary records, and
+// flushes once per batch. When the ring is full, submit() spins/yields until
+// the writer catches up (backpressure), so memory stays bounded.
+class ResultWriter {
+public:
+    explicit ResultWriter(size_t capacity = 4096);
+    ~ResultWriter();
+    
+    // Text results file (header, summary, and solutions in text format)
+    bool open(const std::string& textPath);
+    
+    // Send solutions to a companion binary SolutionFile instead of the text file
+    bool openBinary(const std::string& binaryPath, bool delta);
+    
+    // Open a new PerfectCube_Results_<time>.txt, announced on stdout under tag
+    bool openTimestamped(const std::string& tag);
+    
+    // For the binary --format values, open the .bin companion of the text file
+    // (announced under tag); if that fails solutions stay in the text file
+    void openCompanion(OutputFormat format, const std::string& tag);
+    
+    // "key: value" lines of the header and summary blocks
+    using Fields = std::vector<std::pair<std::string, std::string>>;
+    
+    // Results header: the title, the fields, the start time and the binary
+    // companion if any, between rules. Call before start()
+    void writeHeader(const Fields& fields);
+    
+    // Closing block after finish(): FINAL RESULTS, or PARTIAL RESULTS when the
+    // time limit interrupted the run, then the fields
+    void writeSummary(bool interrupted, const Fields& fields);
+    
+    // Direct access to the text file for header/summary lines; only valid while
+    // the writer thread is not running (before start() or after finish())
+    std::ofstream& text() { return textFile; }
+    
+    // Launch the writer thread; expandOrderings writes all 8! layer orders.
+    // Its per-cube messages go to stdout, or to stderr under --progress=json
+    // so that stdout stays one JSON object per line. announceEach = false
+    // prints [FOUND!] for the first cube only (engines finding millions of
+    // cubes; the progress line keeps counting them)
+    void start(bool expandOrderings, ProgressFormat progress, bool announceEach = true);
+    
+    // Queue a verified-later cube (64 bytes, layer-major); thread-safe, lock-free
+    void submit(long id, const uint8_t cube[kSolutionRecordSize]);
+    
+    // Wait until everything submitted so far is written and flushed to disk
+    void flush();
+    
+    // flush(), then fsync the text and binary files so the solutions survive a crash
+    void sync();
+    
+    // Drain the queue and stop the writer thread
+    void finish();
+    void close();
+    
+    const std::string& getTextPath() const { return textPath; }
+    const std::string& getBinaryPath() const { return binaryPath; }
+    bool isBinary() const { return binaryFile.isOpen(); }
+    long getProcessedCount() const { return processedCount; }  // Written or rejected
+    long getInvalidCount() const { return invalidCount; }
+    long getStallCount() const { return stallCount; }
+    
+    // PerfectCube_Results_YYYYMMDD_HHMMSS.txt style name for a new run
+    static std::string timestampedPath(const std::string& prefix, const std::string& extension);
+    
+private:
+    struct PendingSolution {
+        long id;
+        uint8_t cube[kSolutionRecordSize];
+    };
+    
+    // Vyukov-style bounded queue slot: sequence tells producers/consumer whose turn it is
+    struct Slot {
+        std::atomic<size_t> sequence;
+        PendingSolution item;
+    };
+    
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) size_t dequeuePos{0};  // Writer thread only
+    
+    alignas(64) std::atomic<long> submittedCount{0};
+    std::atomic<long> processedCount{0};
+    std::atomic<long> invalidCount{0};
+    std::atomic<long> stallCount{0};
+    std::atomic<bool> stopping{false};
+    
+    std::thread writerThread;
+    bool expandOrderings{false};
+    bool announceEach{true};
+    bool announcedFirst{false};       // Writer thread only
+    std::ostream* messages{nullptr};  // Set by start()
+    
+    std::string textPath;
+    std::string binaryPath;
+    std::ofstream textFile;
+    SolutionFileWriter binaryFile;
+    
+    bool tryPush(const PendingSolution& item);
+    bool tryPop(PendingSolution& item);
+    void writerLoop();
+    void writeSolution(const PendingSolution& item);
+    void writeRecord(long id, const uint8_t cube[kSolutionRecordSize], long orderingIdx);
+};
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef SEARCHOPTIONS_H
+#define SEARCHOPTIONS_H
+
+#include <cstdint>
+#include <string>
+
+// How solutions are written (--format=text|binary|binary-delta)
+enum class OutputFormat {
+    Text,         // Decorated multi-line blocks in PerfectCube_Results_*.txt
+    Binary,       // 64-byte records in a companion .bin SolutionFile
+    BinaryDelta   // Same, delta-compressed (sequential access only)
+};
+
+// Which search engine runs (--engine=shift|layers|mitm)
+enum class Engine {
+    Shift,        // CubeSearcherV2: 8 shift sets, one per layer
+    Layers,       // LayerGenerator + CubeAssembler: balanced layers, centrally symmetric cube
+    Meet          // MeetInMiddleSearch: shift sets, two 4-layer halves joined on Z counts
+};
+
+// Branching order of the layer engine (--branching=index|fail-first)
+enum class Branching {
+    Index,        // Layers 1-4 picked in ascending id order
+    FailFirst     // Branch on the up number with the fewest candidate layers left
+};
+
+// How the reporter thread prints progress (--progress=human|json|none)
+enum class ProgressFormat {
+    Human,        // One status line, rewritten in place
+    Json,         // One JSON object per line for log pipelines
+    None
+};
+
+// Run-time options shared by the search engines (filled from the command line)
+struct SearchOptions {
+    Engine engine = Engine::Shift;
+    
+    // Cube edge length (--size 4|6|8|16); sizes other than 8 run ShiftCubeSearch<N>
+    int cubeSize = 8;
+    int nThreads = 1;
+    bool findOnlyFirst = true;
+    
+    // Layer order does not affect X/Y/Z balance, so enumerate each unordered
+    // 8-subset of shift sets once instead of every ordered permutation
+    bool combinations = false;
+    
+    // In combination mode, write all 8! layer orderings of every solution
+    bool expandOrderings = false;
+    
+    // Shift engine: only centrally symmetric cubes, whose layers 7..4 are the
+    // complement sets of layers 0..3 (--symmetric)
+    bool symmetric = false;
+    
+    Branching branching = Branching::Index;
+    
+    OutputFormat outputFormat = OutputFormat::Text;
+    
+    // Deterministic split of the task list across machines: this process runs
+    // shard shardIndex of shardCount (--shard i/N)
+    int shardIndex = 0;
+    int shardCount = 1;
+    
+    // Checkpointing: completed tasks are written to checkpointPath every
+    // checkpointInterval seconds (empty path = no checkpoints)
+    std::string checkpointPath;
+    int checkpointInterval = 60;
+    
+    // Skip the tasks already completed in this checkpoint
+    std::string resumePath;
+    
+    // Stop handing out tasks after this many seconds, checkpoint and exit (0 = no limit)
+    long timeLimitSeconds = 0;
+    
+    // Layer engine: load generated layers + index from this file, or write it
+    // after generating them (empty = always generate)
+    std::string layerCachePath;
+    
+    // Find-first portfolio (--portfolio): each thread searches in its own seeded
+    // candidate order with Luby-scheduled restarts (--seed sets the base seed)
+    bool portfolio = false;
+    uint64_t portfolioSeed = 1;
+    
+    // Progress output, sampled every progressInterval seconds
+    ProgressFormat progressFormat = ProgressFormat::Human;
+    int progressInterval = 1;
+    
+    // Write the per-depth node/prune breakdown here as JSON at the end of the run
+    std::string profilePath;
+};
+
+#endif
@@ -0,0 +1,66 @@
+#include "SearchProfile.h"
+#include <fstream>
+
+void SearchProfile::merge(const SearchProfile& other)
+{
+    for (int d = 0; d < kMaxDepth; ++d) {
+        nodes[d] += other.nodes[d];
+        for (int r = 0; r < kReasons; ++r) {
+            pruned[d][r] += other.pruned[d][r];
+        }
+    }
+    leafRejects += other.leafRejects;
+    solutions += other.solutions;
+}
+
+const char* SearchProfile::reasonName(PruneReason reason)
+{
+    switch (reason) {
+        case PruneReason::DuplicateBase: return "duplicate_base";
+        case PruneReason::ZOverflow: return "z_overflow";
+        case PruneReason::ZDeficit: return "z_deficit";
+        case PruneReason::NumberCollision: return "number_collision";
+        case PruneReason::MatrixMismatch: return "matrix_mismatch";
+        case PruneReason::Ordering: return "ordering";
+        default: return "unknown";
+    }
+}
+
+bool SearchProfile::writeJson(const std::string& path, const std::string& engine, double seconds) const
+{
+    std::ofstream out(path);
+    if (!out) return false;
+
+    // Only the depths the engine actually reached
+    int depths = kMaxDepth;
+    while (depths > 1 && nodes[depths - 1] == 0) {
+        bool anyPruned = false;
+        for (int r = 0; r < kReasons; ++r) anyPruned |= pruned[depths - 1][r] != 0;
+        if (anyPruned) break;
+        --depths;
+    }
+
+    uint64_t totalPruned[kReasons] = {};
+    out << "{\n";
+    out << "  \"engine\": \"" << engine << "\",\n";
+    out << "  \"seconds\": " << seconds << ",\n";
+    out << "  \"depths\": [";
+    for (int d = 0; d < depths; ++d) {
+        out << (d ? "," : "") << "\n    {\"depth\": " << d << ", \"nodes\": " << nodes[d] << ", \"pruned\": {";
+        for (int r = 0; r < kReasons; ++r) {
+            out << (r ? ", " : "") << "\"" << reasonName((PruneReason)r) << "\": " << pruned[d][r];
+            totalPruned[r] += pruned[d][r];
+        }
+        out << "}}";
+    }
+    out << "\n  ],\n";
+    out << "  \"pruned_total\": {";
+    for (int r = 0; r < kReasons; ++r) {
+        out << (r ? ", " : "") << "\"" << reasonName((PruneReason)r) << "\": " << totalPruned[r];
+    }
+    out << "},\n";
+    out << "  \"leaf_rejects\": " << leafRejects << ",\n";
+    out << "  \"solutions\": " << solutions << "\n";
+    out << "}\n";
+    return (bool)out;
+}
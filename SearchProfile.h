@@ -0,0 +1,56 @@
+#ifndef SEARCHPROFILE_H
+#define SEARCHPROFILE_H
+
+#include <cstdint>
+#include <string>
+
+// Per-depth search counters (--profile). Each worker fills its own copy with
+// plain increments; the copies are merged only when the run reports. Build
+// with -DPBC_PROFILE=OFF (CMake) to compile every counter update out.
+#ifndef PBC_PROFILE
+#define PBC_PROFILE 1
+#endif
+
+// Why a branch was cut
+enum class PruneReason {
+    DuplicateBase,     // Shift set whose base number is already in the cube
+    ZOverflow,         // A Z column would get a 5th one
+    ZDeficit,          // A Z column can no longer reach 4 ones with the layers left
+    NumberCollision,   // Layer shares a number with the layers already placed
+    MatrixMismatch,    // No layer has the matrix the last level needs
+    Ordering,          // Matching layer comes before the previous one (cube found in another order)
+    Count
+};
+
+struct SearchProfile {
+    // Depth = number of layers placed (0..16, for cube sizes up to 16)
+    static constexpr int kMaxDepth = 17;
+    static constexpr int kReasons = (int)PruneReason::Count;
+
+    uint64_t nodes[kMaxDepth] = {};                // Nodes visited per depth
+    uint64_t pruned[kMaxDepth][kReasons] = {};     // Candidates cut at depth, per reason
+    uint64_t leafRejects = 0;                      // Complete cubes failing the final check
+    uint64_t solutions = 0;
+
+    void merge(const SearchProfile& other);
+
+    // Write the breakdown as one JSON document; false if the file can't be written
+    bool writeJson(const std::string& path, const std::string& engine, double seconds) const;
+
+    static const char* reasonName(PruneReason reason);
+};
+
+#if PBC_PROFILE
+#define PBC_PROFILE_NODE(profile, depth) ((profile).nodes[depth]++)
+#define PBC_PROFILE_PRUNE(profile, depth, reason, n) ((profile).pruned[depth][(int)(reason)] += (n))
+#define PBC_PROFILE_LEAF_REJECT(profile) ((profile).leafRejects++)
+#define PBC_PROFILE_SOLUTION(profile) ((profile).solutions++)
+#else
+// Arguments are still named (and discarded) so OFF builds stay free of unused warnings
+#define PBC_PROFILE_NODE(profile, depth) ((void)(profile), (void)(depth))
+#define PBC_PROFILE_PRUNE(profile, depth, reason, n) ((void)(profile), (void)(depth), (void)(reason), (void)(n))
+#define PBC_PROFILE_LEAF_REJECT(profile) ((void)(profile))
+#define PBC_PROFILE_SOLUTION(profile) ((void)(profile))
+#endif
+
+#endif
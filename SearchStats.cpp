@@ -0,0 +1,21 @@
+#include "SearchStats.h"
+#include <iomanip>
+#include <iostream>
+
+void SearchStats::print() const
+{
+    // This segment's paths over this segment's time; a resumed run adds the cumulative total
+    double rate = seconds > 0 ? pathsChecked / seconds / 1000000.0 : 0;
+    
+    std::cout << "[STATS] engine=" << engine
+              << " threads=" << threads
+              << " time=" << std::fixed << std::setprecision(2) << seconds << "s"
+              << " paths=" << pathsChecked;
+    if (resumedPaths > 0) std::cout << " total_paths=" << pathsChecked + resumedPaths;
+    std::cout
+              << " rate=" << std::setprecision(2) << rate << "M/s"
+              << " cubes=" << cubesFound
+              << " invalid=" << invalidCubes
+              << " complete=" << (complete ? "yes" : "no")
+              << std::endl;
+}
@@ -0,0 +1,21 @@
+#ifndef SEARCHSTATS_H
+#define SEARCHSTATS_H
+
+#include <string>
+
+// End-of-run numbers reported the same way by every engine, so runs of the
+// shift-set and layer engines can be compared line by line
+struct SearchStats {
+    std::string engine;        // "shift" or "layers"
+    int threads{0};
+    double seconds{0};
+    long pathsChecked{0};      // Candidates examined in this run (engine-specific unit)
+    long resumedPaths{0};      // Candidates of earlier run segments (--resume), not in pathsChecked
+    long cubesFound{0};
+    long invalidCubes{0};      // Rejected by the result writer's verification
+    bool complete{false};      // Whole search space covered (not stopped early)
+    
+    void print() const;
+};
+
+#endif
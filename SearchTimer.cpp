@@ -0,0 +1,28 @@
+#include "SearchTimer.h"
+#include <chrono>
+
+SearchTimer::SearchTimer(long seconds, std::function<void()> onExpire)
+{
+    if (seconds <= 0) return;
+    thread = std::thread([this, seconds, onExpire = std::move(onExpire)]() {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (!cv.wait_for(lock, std::chrono::seconds(seconds), [this]() { return done; })) {
+            onExpire();
+        }
+    });
+}
+
+SearchTimer::~SearchTimer()
+{
+    stop();
+}
+
+void SearchTimer::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        done = true;
+    }
+    cv.notify_all();
+    if (thread.joinable()) thread.join();
+}
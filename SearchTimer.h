@@ -0,0 +1,30 @@
+#ifndef SEARCHTIMER_H
+#define SEARCHTIMER_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+// --time-limit for the search engines: a thread that calls onExpire once the
+// limit has passed, unless stop() (the search finishing first) wakes it early.
+// A limit of zero or less never expires and starts no thread.
+class SearchTimer {
+public:
+    SearchTimer(long seconds, std::function<void()> onExpire);
+    ~SearchTimer();
+
+    SearchTimer(const SearchTimer&) = delete;
+    SearchTimer& operator=(const SearchTimer&) = delete;
+
+    // Cancel the limit and join the timer thread (idempotent)
+    void stop();
+
+private:
+    std::thread thread;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool done{false};
+};
+
+#endif
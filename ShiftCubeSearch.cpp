@@ -0,0 +1,134 @@
+#include "ShiftCubeSearch.h"
+#include "ProgressReporter.h"
+#include "SearchTimer.h"
+#include "WorkStealingPool.h"
+#include <chrono>
+#include <iostream>
+
+template <int N>
+ShiftCubeSearch<N>::ShiftCubeSearch(const BasicBalancedSet<N>& bSet)
+    : core(bSet, stopRequested, [this](const CubeLayers& cube, typename Core::TaskContext& ctx) {
+          return acceptCube(cube, ctx);
+      })
+{
+}
+
+template <int N>
+bool ShiftCubeSearch<N>::isPerfect(const CubeLayers& cube)
+{
+    for (int z = 0; z < N; ++z) {
+        for (int a = 0; a < N; ++a) {
+            // X: row a of layer z; Y: bit a of every row of layer z
+            int xOnes = 0, yOnes = 0;
+            for (int b = 0; b < N; ++b) {
+                xOnes += (cube[z].values[a] >> b) & 1;
+                yOnes += (cube[z].values[b] >> a) & 1;
+            }
+            if (xOnes != Traits::kHalf || yOnes != Traits::kHalf) return false;
+        }
+    }
+    // Z: cell (row, bit) across the layers
+    for (int row = 0; row < N; ++row) {
+        for (int bit = 0; bit < N; ++bit) {
+            int zOnes = 0;
+            for (int z = 0; z < N; ++z) zOnes += (cube[z].values[row] >> bit) & 1;
+            if (zOnes != Traits::kHalf) return false;
+        }
+    }
+    return true;
+}
+
+template <int N>
+void ShiftCubeSearch<N>::search(const SearchOptions& options)
+{
+    const int nThreads = std::max(1, options.nThreads);
+    const bool combinations = options.combinations;
+    findOnlyFirst = options.findOnlyFirst;
+    foundCount = 0;
+    stopRequested = false;
+    firstCubeFound = false;
+    interrupted = false;
+    profile = SearchProfile();
+
+    core.prepare(combinations, false, kTaskDepth);
+    const auto& taskPrefixes = core.getTaskPrefixes();
+    const int numTasks = taskPrefixes.size();
+    std::cout << "[ShiftCubeSearch] " << N << "x" << N << "x" << N << " cube, "
+              << Traits::kHalf << " ones per line" << std::endl;
+    std::cout << "[ShiftCubeSearch] Filtered shift sets: " << core.setCount() << " | Layer words: "
+              << Traits::kWords << " | Z counter planes: " << Traits::kPlanes << std::endl;
+    std::cout << "[ShiftCubeSearch] Mode: " << (findOnlyFirst ? "FIND FIRST ONLY" : "FIND ALL")
+              << " | Enumeration: " << (combinations ? "COMBINATIONS" : "PERMUTATIONS")
+              << " | Tasks: " << numTasks << std::endl << std::endl;
+
+    auto startTime = std::chrono::steady_clock::now();
+    WorkStealingPool pool(nThreads);
+    std::atomic<int> processedTasks{0};
+    std::atomic<long> totalChecked{0};
+    std::vector<SearchProfile> workerProfiles(nThreads);
+    std::vector<typename Core::TaskContext> workerContexts(nThreads);
+
+    ProgressReporter reporter(options, "shift-n" + std::to_string(N), nThreads, numTasks, "Tasks");
+    reporter.setFoundCounter([this]() { return foundCount.load(std::memory_order_relaxed); });
+    reporter.start();
+
+    // Time limit: raises the stop token
+    SearchTimer timer(options.timeLimitSeconds, [this, &pool]() {
+        interrupted = true;
+        stopRequested = true;
+        pool.requestStop();
+    });
+
+    pool.run(numTasks, [&](int worker, int task) {
+        if (stopRequested.load(std::memory_order_relaxed)) {
+            pool.requestStop();
+            return;
+        }
+        typename Core::TaskContext& ctx = workerContexts[worker];
+        ctx.checked = 0;
+        ctx.profile = SearchProfile();
+        core.runTask(taskPrefixes[task], ctx);
+
+        totalChecked += ctx.checked;
+        workerProfiles[worker].merge(ctx.profile);
+        reporter.add(worker, ctx.checked, 1);
+        ++processedTasks;
+    });
+
+    timer.stop();
+    reporter.stop();
+
+    for (const SearchProfile& p : workerProfiles) profile.merge(p);
+
+    auto endTime = std::chrono::steady_clock::now();
+    stats.engine = "shift-n" + std::to_string(N);
+    stats.threads = nThreads;
+    stats.seconds = std::chrono::duration<double>(endTime - startTime).count();
+    stats.pathsChecked = totalChecked.load();
+    stats.cubesFound = foundCount.load();
+    stats.invalidCubes = 0;
+    stats.complete = processedTasks == numTasks && !stopRequested;
+
+    std::cout << "\n[ShiftCubeSearch] " << (interrupted ? "Time limit reached!" : "Search complete!") << std::endl;
+    std::cout << "[ShiftCubeSearch] Perfect cubes found: " << foundCount.load()
+              << (combinations ? " (unordered layer sets)" : "") << std::endl;
+}
+
+template <int N>
+bool ShiftCubeSearch<N>::acceptCube(const CubeLayers& cube, typename Core::TaskContext&)
+{
+    // The Z counters already force every column to N/2; this also checks X and Y
+    if (!isPerfect(cube)) return false;
+
+    if (++foundCount == 1) {
+        std::lock_guard<std::mutex> lock(mtx);
+        firstCube = cube;
+        firstCubeFound.store(true, std::memory_order_release);
+    }
+    if (findOnlyFirst) stopRequested = true;
+    return true;
+}
+
+template class ShiftCubeSearch<4>;
+template class ShiftCubeSearch<6>;
+template class ShiftCubeSearch<16>;
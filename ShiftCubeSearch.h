@@ -0,0 +1,67 @@
+#ifndef SHIFTCUBESEARCH_H
+#define SHIFTCUBESEARCH_H
+
+#include "BalancedSet.h"
+#include "CubeTraits.h"
+#include "SearchOptions.h"
+#include "SearchProfile.h"
+#include "SearchStats.h"
+#include "ShiftSearchCore.h"
+#include <array>
+#include <atomic>
+#include <mutex>
+
+// The shift-set search for an N×N×N cube (--size N). The search loop is
+// CubeSearcherV2's ShiftSearchCore<N>; this driver only adds the thread pool,
+// progress, time limit and counting, without CubeSearcherV2's 8-specific
+// checkpoint and result-file machinery: cubes are counted and the first one
+// is kept. Instantiated for N = 4, 6 and 16 in ShiftCubeSearch.cpp (N = 8
+// runs the full CubeSearcherV2).
+template <int N>
+class ShiftCubeSearch {
+public:
+    using Traits = CubeTraits<N>;
+    using ShiftSetType = BasicShiftSet<N>;
+    using CubeLayers = std::array<ShiftSetType, N>;
+
+    explicit ShiftCubeSearch(const BasicBalancedSet<N>& bSet);
+
+    void search(const SearchOptions& options);
+
+    long getCubeCount() const { return foundCount; }
+    bool wasInterrupted() const { return interrupted; }
+    const SearchStats& getStats() const { return stats; }
+    const SearchProfile& getProfile() const { return profile; }
+    const CubeLayers* getFirstCube() const { return firstCubeFound ? &firstCube : nullptr; }
+
+    // Check all 3N² lines of a complete cube
+    static bool isPerfect(const CubeLayers& cube);
+
+private:
+    using Core = ShiftSearchCore<N>;
+
+    // One task per first layer: the N=16 tree has 4864 of them, while a
+    // depth-2 split would already list 23.6M prefixes
+    static constexpr int kTaskDepth = 1;
+
+    bool findOnlyFirst{true};
+
+    std::atomic<long> foundCount{0};
+    std::atomic<bool> stopRequested{false};
+    std::atomic<bool> firstCubeFound{false};
+    bool interrupted{false};
+    CubeLayers firstCube;
+    std::mutex mtx;
+    SearchStats stats;
+    SearchProfile profile;
+    Core core;
+
+    // Leaf of the core's search: check all lines, count the cube, keep the first
+    bool acceptCube(const CubeLayers& cube, typename Core::TaskContext& ctx);
+};
+
+extern template class ShiftCubeSearch<4>;
+extern template class ShiftCubeSearch<6>;
+extern template class ShiftCubeSearch<16>;
+
+#endif
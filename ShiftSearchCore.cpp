@@ -0,0 +1,223 @@
+#include "ShiftSearchCore.h"
+#include <algorithm>
+
+template <int N>
+ShiftSearchCore<N>::ShiftSearchCore(const BasicBalancedSet<N>& bSet, const std::atomic<bool>& stop, Leaf onLeaf)
+    : balancedSet(bSet), stopRequested(stop), leaf(std::move(onLeaf)), cells(Traits::cellMask())
+{
+}
+
+template <int N>
+void ShiftSearchCore<N>::prepare(bool combinationMode, bool symmetricMode, int depth)
+{
+    combinations = combinationMode;
+    symmetric = symmetricMode;
+    taskDepth = std::min(depth, kMaxTaskDepth);
+
+    // Pack every filtered set once so the search can update Z counters with a few ANDs/XORs
+    const auto& shiftSets = balancedSet.getFilteredShiftSets();
+    const int numSets = shiftSets.size();
+    setMatrices.clear();
+    for (const ShiftSetType& set : shiftSets) {
+        setMatrices.push_back(Traits::pack(set.values));
+    }
+
+    // Complementing every row of a shift set gives the shift set of the complement base
+    complementIdx.assign(numSets, -1);
+    for (int c = 0; c < numSets; ++c) {
+        auto complementBase = balancedSet.getComplement(shiftSets[c].base);
+        for (int d = 0; d < numSets; ++d) {
+            if (shiftSets[d].base == complementBase) complementIdx[c] = d;
+        }
+    }
+
+    taskPrefixes.clear();
+    Prefix root{};
+    Board empty[Traits::kPlanes];
+    for (Board& plane : empty) Traits::clear(plane);
+    buildTaskPrefixes(root, 0, empty);
+}
+
+template <int N>
+void ShiftSearchCore<N>::buildTaskPrefixes(Prefix& prefix, int depth, const Board counts[Traits::kPlanes])
+{
+    // (taskDepth never exceeds kMaxTaskDepth; the second test lets the compiler see that)
+    if (depth == taskDepth || depth == kMaxTaskDepth) {
+        taskPrefixes.push_back(prefix);
+        return;
+    }
+
+    const int numSets = setMatrices.size();
+    const int first = (combinations && depth > 0) ? prefix.setIdx[depth - 1] + 1 : 0;
+
+    for (int c = first; c < numSets; ++c) {
+        // Same set rules as searchStack
+        bool alreadyUsed = false;
+        for (int d = 0; d < depth; ++d) {
+            if (prefix.setIdx[d] == c) alreadyUsed = true;
+        }
+        if (alreadyUsed) continue;
+
+        // Symmetric mode: the complement set fills layer N-1-depth, so it must
+        // exist and be unused too (combinations: lower index of each pair only)
+        if (symmetric) {
+            int comp = complementIdx[c];
+            if (comp < 0 || (combinations && comp < c)) continue;
+            for (int d = 0; d < depth; ++d) {
+                if (complementIdx[prefix.setIdx[d]] == c) alreadyUsed = true;
+            }
+            if (alreadyUsed) continue;
+        }
+
+        // Combination mode: leave enough later sets to fill the chosen layers
+        if (combinations && numSets - c < chosenLayers() - depth) break;
+
+        Board next[Traits::kPlanes];
+        if (!addLayer(counts, setMatrices[c], depth + 1, next)) continue;
+
+        prefix.setIdx[depth] = (uint16_t)c;
+        buildTaskPrefixes(prefix, depth + 1, next);
+    }
+}
+
+template <int N>
+void ShiftSearchCore<N>::runTask(const Prefix& prefix, TaskContext& ctx) const
+{
+    const auto& shiftSets = balancedSet.getFilteredShiftSets();
+    SearchState state;
+    state.used.fill(0);
+    Board* counts = state.frames[0].counts;
+    for (int p = 0; p < Traits::kPlanes; ++p) Traits::clear(counts[p]);
+
+    for (int d = 0; d < taskDepth; ++d) {
+        int c = prefix.setIdx[d];
+        state.cube[d] = shiftSets[c];
+        toggleUsed(state, c);
+        addLayer(state.frames[d].counts, setMatrices[c], d + 1, state.frames[d + 1].counts);
+    }
+
+    state.frames[taskDepth].next = (combinations && taskDepth > 0) ? prefix.setIdx[taskDepth - 1] + 1 : 0;
+    searchStack<false>(state, taskDepth, ctx, nullptr, 0);
+}
+
+template <int N>
+bool ShiftSearchCore<N>::runOrdered(const std::vector<uint16_t>& order, uint64_t budget, TaskContext& ctx) const
+{
+    SearchState state;
+    state.used.fill(0);
+    for (int p = 0; p < Traits::kPlanes; ++p) Traits::clear(state.frames[0].counts[p]);
+    state.frames[0].next = 0;
+    return searchStack<true>(state, 0, ctx, order.data(), budget);
+}
+
+template <int N>
+void ShiftSearchCore<N>::toggleUsed(SearchState& state, int c) const
+{
+    state.used[c / 64] ^= 1ULL << (c % 64);
+    if (symmetric) {
+        int comp = complementIdx[c];
+        state.used[comp / 64] ^= 1ULL << (comp % 64);
+    }
+}
+
+template <int N>
+template <bool Ordered>
+bool ShiftSearchCore<N>::searchStack(SearchState& state, int rootDepth, TaskContext& ctx, const uint16_t* order,
+                                     uint64_t budget) const
+{
+    const auto& shiftSets = balancedSet.getFilteredShiftSets();
+    const int numSets = setMatrices.size();
+    const int leafDepth = chosenLayers();
+    int depth = rootDepth;
+    PBC_PROFILE_NODE(ctx.profile, depth);
+
+    for (;;) {
+        SearchFrame& frame = state.frames[depth];
+        // Combination mode: fewer sets left than layers to fill ends the level too
+        if (frame.next >= numSets || (combinations && numSets - frame.next < leafDepth - depth)) {
+            // Subtree exhausted: back up one level and take the set there off the cube
+            if (depth == rootDepth) return true;
+            --depth;
+            toggleUsed(state, state.frames[depth].placed);
+            continue;
+        }
+
+        // Exit early if the owner raised the stop token
+        if (stopRequested.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        if (Ordered && budget-- == 0) {
+            return false;
+        }
+
+        const int pos = frame.next++;
+        const int c = Ordered ? order[pos] : pos;
+        ctx.checked++;
+
+        if (isUsed(state, c)) {
+            PBC_PROFILE_PRUNE(ctx.profile, depth, PruneReason::DuplicateBase, 1);
+            continue;
+        }
+
+        // Symmetric mode: the complement set must be available and unused as well
+        if (symmetric) {
+            int comp = complementIdx[c];
+            if (comp < 0 || (combinations && comp < c)) {
+                PBC_PROFILE_PRUNE(ctx.profile, depth, PruneReason::Ordering, 1);
+                continue;
+            }
+            if (isUsed(state, comp)) {
+                PBC_PROFILE_PRUNE(ctx.profile, depth, PruneReason::DuplicateBase, 1);
+                continue;
+            }
+        }
+
+        // Z pruning: overflowing cell, or a cell that can no longer reach N/2 ones
+        SearchFrame& child = state.frames[depth + 1];
+        if (!addLayer(frame.counts, setMatrices[c], depth + 1, child.counts)) {
+            PBC_PROFILE_PRUNE(ctx.profile, depth,
+                              Traits::isZero(Traits::full(frame.counts) & setMatrices[c]) ? PruneReason::ZDeficit
+                                                                                         : PruneReason::ZOverflow, 1);
+            continue;
+        }
+
+        // Place this set and continue one level down
+        state.cube[depth] = shiftSets[c];
+        frame.placed = c;
+        toggleUsed(state, c);
+        child.next = combinations ? pos + 1 : 0;
+        ++depth;
+        PBC_PROFILE_NODE(ctx.profile, depth);
+
+        if (depth == leafDepth) {
+            // Symmetric: the chosen sets' complements complete a cube by construction
+            if (symmetric) completeSymmetric(state.cube);
+            if (leaf(state.cube, ctx)) {
+                PBC_PROFILE_SOLUTION(ctx.profile);
+            } else {
+                PBC_PROFILE_LEAF_REJECT(ctx.profile);
+            }
+            --depth;
+            toggleUsed(state, c);
+        }
+    }
+}
+
+template <int N>
+void ShiftSearchCore<N>::completeSymmetric(CubeLayers& cube) const
+{
+    // A set and its complement put exactly one 1 into every Z cell, so the N/2
+    // pairs give every cell N/2 ones: nothing is left to check
+    for (int z = 0; z < N / 2; ++z) {
+        ShiftSetType& mirror = cube[N - 1 - z];
+        mirror.base = balancedSet.getComplement(cube[z].base);
+        for (int row = 0; row < N; ++row) {
+            mirror.values[row] = balancedSet.getComplement(cube[z].values[row]);
+        }
+    }
+}
+
+template class ShiftSearchCore<4>;
+template class ShiftSearchCore<6>;
+template class ShiftSearchCore<8>;
+template class ShiftSearchCore<16>;
@@ -0,0 +1,136 @@
+#ifndef SHIFTSEARCHCORE_H
+#define SHIFTSEARCHCORE_H
+
+#include "BalancedSet.h"
+#include "CubeTraits.h"
+#include "SearchProfile.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// The shift-set search loop of an N×N×N cube, shared by CubeSearcherV2 (N = 8)
+// and ShiftCubeSearch<N> (--size N): one distinct filtered shift set per layer,
+// bit-sliced Z counters for pruning. The tree is split into task prefixes of
+// the first taskDepth layers; runTask() searches one prefix's subtree on an
+// explicit stack, polls the stop token at every candidate and hands every
+// complete cube to the owner's leaf callback. runOrdered() searches the whole
+// tree the same way in a caller's candidate order under a node budget (the
+// --portfolio restarts). Instantiated for N = 4, 6, 8 and 16 in
+// ShiftSearchCore.cpp.
+template <int N>
+class ShiftSearchCore {
+public:
+    using Traits = CubeTraits<N>;
+    using Board = typename Traits::Board;
+    using ShiftSetType = BasicShiftSet<N>;
+    using CubeLayers = std::array<ShiftSetType, N>;
+
+    // Deepest task split (CubeSearcherV2's)
+    static constexpr int kMaxTaskDepth = 3;
+
+    // Root of one scheduled subtree: its first taskDepth layers, as indices
+    // into the filtered shift sets
+    struct Prefix {
+        std::array<uint16_t, kMaxTaskDepth> setIdx;
+    };
+
+    // Per-task counters; each worker reuses one context, so cubeIds keeps its capacity
+    struct TaskContext {
+        long checked = 0;
+        std::vector<long> cubeIds;  // Ids of cubes the owner recorded while running this task
+        SearchProfile profile;
+    };
+
+    // Called with every complete cube (symmetric cubes already completed);
+    // returns false to reject it, true once the owner has recorded it
+    using Leaf = std::function<bool(const CubeLayers& cube, TaskContext& ctx)>;
+
+    // stop is the owner's stop token; it must outlive the core
+    ShiftSearchCore(const BasicBalancedSet<N>& bSet, const std::atomic<bool>& stop, Leaf leaf);
+
+    // Pack the filtered sets and enumerate every task prefix that survives the
+    // set and Z rules, in search order. combinations: set indices increase with
+    // the layer. symmetric: only layers 0..N/2-1 are chosen, layer N-1-z is
+    // the complement set of layer z.
+    void prepare(bool combinations, bool symmetric, int taskDepth);
+
+    const std::vector<Prefix>& getTaskPrefixes() const { return taskPrefixes; }
+    int setCount() const { return setMatrices.size(); }
+    const Board& setMatrix(int c) const { return setMatrices[c]; }
+
+    // Layers chosen by the search: N, or N/2 in symmetric mode
+    int chosenLayers() const { return symmetric ? N / 2 : N; }
+
+    // Rebuild the partial cube for a prefix and search its subtree
+    void runTask(const Prefix& prefix, TaskContext& ctx) const;
+    
+    // Search the whole tree trying candidates in order (a permutation of the
+    // filtered set indices; combination mode takes increasing positions in
+    // it) and give up after budget candidates. True if the tree was exhausted,
+    // false if the budget ran out or the stop token was raised.
+    bool runOrdered(const std::vector<uint16_t>& order, uint64_t budget, TaskContext& ctx) const;
+
+    // Add one layer's matrix to the bit-sliced Z counters of placedLayers - 1
+    // layers; false if a cell overflows N/2 or can no longer reach it
+    bool addLayer(const Board counts[Traits::kPlanes], const Board& matrix, int placedLayers,
+                  Board next[Traits::kPlanes]) const
+    {
+        return Traits::addLayer(counts, matrix, placedLayers, next, cells);
+    }
+
+private:
+    const BasicBalancedSet<N>& balancedSet;
+    const std::atomic<bool>& stopRequested;
+    Leaf leaf;
+
+    std::vector<Board> setMatrices;   // Packed filtered shift sets
+    Board cells;                      // Board bits that are cube cells
+    std::vector<int> complementIdx;   // Filtered set -> its complement set, or -1
+    bool combinations{false};
+    bool symmetric{false};
+    int taskDepth{kMaxTaskDepth};
+    std::vector<Prefix> taskPrefixes;
+
+    // One level of the explicit search stack: the Z counters of the layers
+    // below it and the next candidate to try at this depth
+    struct SearchFrame {
+        Board counts[Traits::kPlanes];
+        int next;        // Candidate index (ordered: position in the order)
+        int placed;      // Set placed at this depth while its subtree runs
+    };
+
+    // Complete search state of one task: fixed-size, so a subtree runs without
+    // touching the heap. used marks the filtered sets in the cube (filtered
+    // sets have distinct bases, so this is the distinct-base rule).
+    struct SearchState {
+        CubeLayers cube;
+        std::array<uint64_t, (Traits::kBalanced + 63) / 64> used;
+        SearchFrame frames[N + 1];
+    };
+
+    void buildTaskPrefixes(Prefix& prefix, int depth, const Board counts[Traits::kPlanes]);
+
+    // Mark (or clear) set c, and in symmetric mode its complement set
+    void toggleUsed(SearchState& state, int c) const;
+    static bool isUsed(const SearchState& state, int c) { return (state.used[c / 64] >> (c % 64)) & 1; }
+
+    // Depth-first search below rootDepth placed layers; frames[rootDepth] must
+    // hold the Z counters and first candidate of the root. Ordered: frames
+    // step through positions of order and the search stops after budget
+    // candidates. True if the subtree was exhausted
+    template <bool Ordered>
+    bool searchStack(SearchState& state, int rootDepth, TaskContext& ctx, const uint16_t* order,
+                     uint64_t budget) const;
+
+    // Symmetric mode: fill layers N/2..N-1 with the complements of layers 0..N/2-1
+    void completeSymmetric(CubeLayers& cube) const;
+};
+
+extern template class ShiftSearchCore<4>;
+extern template class ShiftSearchCore<6>;
+extern template class ShiftSearchCore<8>;
+extern template class ShiftSearchCore<16>;
+
+#endif
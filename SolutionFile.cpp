@@ -0,0 +1,155 @@
+#include "SolutionFile.h"
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char kSolutionMagic[8] = {'P', 'B', 'C', 'S', 'O', 'L', '0', '1'};
+
+}
+
+bool SolutionFileWriter::open(const std::string& path, bool delta)
+{
+    close();
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    
+    deltaMode = delta;
+    recordCount = 0;
+    std::memset(previous, 0, sizeof(previous));
+    
+    SolutionFileHeader header = {};
+    std::memcpy(header.magic, kSolutionMagic, sizeof(header.magic));
+    header.version = kSolutionFileVersion;
+    header.flags = delta ? kFlagDelta : 0;
+    std::fwrite(&header, sizeof(header), 1, file);
+    return true;
+}
+
+void SolutionFileWriter::append(const uint8_t cube[kSolutionRecordSize])
+{
+    if (!file) return;
+    
+    if (!deltaMode) {
+        std::fwrite(cube, kSolutionRecordSize, 1, file);
+    } else {
+        uint8_t packed[8 + kSolutionRecordSize];
+        uint64_t mask = 0;
+        size_t n = 8;
+        for (size_t i = 0; i < kSolutionRecordSize; ++i) {
+            uint8_t diff = cube[i] ^ previous[i];
+            if (diff) {
+                mask |= (1ULL << i);
+                packed[n++] = diff;
+            }
+        }
+        std::memcpy(packed, &mask, 8);
+        std::fwrite(packed, n, 1, file);
+        std::memcpy(previous, cube, kSolutionRecordSize);
+    }
+    recordCount++;
+}
+
+void SolutionFileWriter::flush()
+{
+    if (file) std::fflush(file);
+}
+
+void SolutionFileWriter::sync()
+{
+#ifndef _WIN32
+    if (file) fsync(fileno(file));
+#endif
+}
+
+void SolutionFileWriter::close()
+{
+    if (!file) return;
+    
+    // Patch the record count into the header
+    std::fseek(file, offsetof(SolutionFileHeader, recordCount), SEEK_SET);
+    std::fwrite(&recordCount, sizeof(recordCount), 1, file);
+    std::fclose(file);
+    file = nullptr;
+}
+
+bool SolutionFileReader::open(const std::string& path)
+{
+    if (!mapping.open(path)) {
+        std::cout << "[SolutionFile] ERROR: Cannot open " << path << std::endl;
+        return false;
+    }
+    
+    SolutionFileHeader header;
+    if (mapping.size() < sizeof(header)) {
+        std::cout << "[SolutionFile] ERROR: " << path << " is too small" << std::endl;
+        return false;
+    }
+    std::memcpy(&header, mapping.data(), sizeof(header));
+    if (std::memcmp(header.magic, kSolutionMagic, sizeof(kSolutionMagic)) != 0 ||
+        header.version != kSolutionFileVersion) {
+        std::cout << "[SolutionFile] ERROR: " << path << " is not a version "
+                  << kSolutionFileVersion << " solution file" << std::endl;
+        return false;
+    }
+    
+    deltaMode = (header.flags & kFlagDelta) != 0;
+    records = mapping.data() + sizeof(header);
+    if (deltaMode) {
+        // Count complete records by walking the masks (the header count is zero
+        // if the writer died before close())
+        const uint8_t* p = records;
+        const uint8_t* end = mapping.data() + mapping.size();
+        recordCount = 0;
+        while (p + 8 <= end) {
+            uint64_t mask;
+            std::memcpy(&mask, p, 8);
+            size_t changed = __builtin_popcountll(mask);
+            if (p + 8 + changed > end) break;
+            p += 8 + changed;
+            recordCount++;
+        }
+    } else {
+        // The size is authoritative: a writer that died before close() left a
+        // zero count in the header, but every complete record is still valid
+        recordCount = (mapping.size() - sizeof(header)) / kSolutionRecordSize;
+    }
+    return true;
+}
+
+void SolutionFileReader::forEach(const std::function<bool(const uint8_t* cube)>& visit) const
+{
+    if (!deltaMode) {
+        for (uint64_t i = 0; i < recordCount; ++i) {
+            if (!visit(record(i))) return;
+        }
+        return;
+    }
+    
+    uint8_t cube[kSolutionRecordSize] = {};
+    const uint8_t* p = records;
+    for (uint64_t i = 0; i < recordCount; ++i) {
+        uint64_t mask;
+        std::memcpy(&mask, p, 8);
+        p += 8;
+        
+        while (mask) {
+            int byte = __builtin_ctzll(mask);
+            cube[byte] ^= *p++;
+            mask &= mask - 1;
+        }
+        if (!visit(cube)) return;
+    }
+}
+
+bool SolutionFileReader::isSolutionFile(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    char magic[8];
+    return in.read(magic, sizeof(magic)) && std::memcmp(magic, kSolutionMagic, sizeof(magic)) == 0;
+}
@@ -0,0 +1,78 @@
+#ifndef SOLUTIONFILE_H
+#define SOLUTIONFILE_H
+
+#include "MappedFile.h"
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+
+// Compact binary solution format.
+//
+// A 64-byte header followed by one record per cube. A record is the cube's 64
+// bytes in layer-major order (byte z*8 + row = row of layer z); for shift-set
+// cubes the layer base is the layer's first row.
+//
+// Delta-compressed files (kFlagDelta) store each record XORed with the previous
+// one as an 8-byte mask of non-zero bytes followed by those bytes. Consecutive
+// solutions share most layers, so this usually shrinks files several times, at
+// the cost of sequential-only access.
+struct SolutionFileHeader {
+    char magic[8];          // "PBCSOL01"
+    uint32_t version;       // kSolutionFileVersion
+    uint32_t flags;         // kFlagDelta
+    uint64_t recordCount;   // Filled in on close (fixed files also trust the file size)
+    uint8_t reserved[40];
+};
+static_assert(sizeof(SolutionFileHeader) == 64, "SolutionFileHeader must stay 64 bytes");
+
+constexpr uint32_t kSolutionFileVersion = 1;
+constexpr uint32_t kFlagDelta = 1;
+constexpr size_t kSolutionRecordSize = 64;
+
+// Append-only writer (not thread-safe; callers serialize appends)
+class SolutionFileWriter {
+public:
+    ~SolutionFileWriter() { close(); }
+    
+    bool open(const std::string& path, bool delta);
+    void append(const uint8_t cube[kSolutionRecordSize]);
+    void flush();
+    void sync();   // fsync what flush() handed to the OS
+    void close();
+    
+    bool isOpen() const { return file != nullptr; }
+    uint64_t getRecordCount() const { return recordCount; }
+    
+private:
+    FILE* file{nullptr};
+    bool deltaMode{false};
+    uint64_t recordCount{0};
+    uint8_t previous[kSolutionRecordSize] = {};
+};
+
+// Memory-mapped reader; fixed-record files allow random access
+class SolutionFileReader {
+public:
+    bool open(const std::string& path);
+    
+    uint64_t size() const { return recordCount; }
+    bool isDelta() const { return deltaMode; }
+    
+    // Fixed-record files only: pointer to record i inside the mapping
+    const uint8_t* record(uint64_t i) const { return records + i * kSolutionRecordSize; }
+    
+    // Visit every record in file order (works for both layouts); stops early
+    // if the callback returns false
+    void forEach(const std::function<bool(const uint8_t* cube)>& visit) const;
+    
+    static bool isSolutionFile(const std::string& path);
+    
+private:
+    MappedFile mapping;
+    const uint8_t* records{nullptr};
+    uint64_t recordCount{0};
+    bool deltaMode{false};
+};
+
+#endif
@@ -0,0 +1,62 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <thread>
+
+WorkStealingPool::WorkStealingPool(int nThreads)
+    : nThreads(std::max(1, nThreads)), queues(std::max(1, nThreads)) {}
+
+void WorkStealingPool::run(int nTasks, const std::function<void(int, int)>& task)
+{
+    stopRequested = false;
+    
+    // Seed each deque with a contiguous block so owners walk tasks in order
+    int chunk = (nTasks + nThreads - 1) / nThreads;
+    for (int t = 0; t < nThreads; ++t) {
+        int start = t * chunk;
+        int end = std::min(start + chunk, nTasks);
+        queues[t].tasks.clear();
+        for (int i = start; i < end; ++i) {
+            queues[t].tasks.push_back(i);
+        }
+    }
+    
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nThreads; ++t) {
+        threads.emplace_back([this, t, &task]() {
+            int taskIdx;
+            while (!stopRequested) {
+                if (!popLocal(t, taskIdx) && !steal(t, taskIdx)) {
+                    // Tasks never spawn new tasks, so all deques empty means we are done
+                    break;
+                }
+                task(t, taskIdx);
+            }
+        });
+    }
+    
+    for (auto& th : threads) th.join();
+}
+
+bool WorkStealingPool::popLocal(int threadId, int& taskIdx)
+{
+    WorkerQueue& q = queues[threadId];
+    std::lock_guard<std::mutex> lock(q.mtx);
+    if (q.tasks.empty()) return false;
+    taskIdx = q.tasks.front();
+    q.tasks.pop_front();
+    return true;
+}
+
+bool WorkStealingPool::steal(int threadId, int& taskIdx)
+{
+    // Visit victims starting after ourselves so thieves spread over different deques
+    for (int offset = 1; offset < nThreads; ++offset) {
+        WorkerQueue& victim = queues[(threadId + offset) % nThreads];
+        std::lock_guard<std::mutex> lock(victim.mtx);
+        if (victim.tasks.empty()) continue;
+        taskIdx = victim.tasks.back();
+        victim.tasks.pop_back();
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,41 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// Fixed-size thread pool that runs a list of independent tasks (identified by index).
+// Each worker owns a deque seeded with a contiguous block of tasks: the owner takes
+// from the front (keeping the original task order), idle workers steal from the back
+// of a victim's deque, so every core stays busy until the last task finishes.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(int nThreads);
+    
+    // Run task(threadId, taskIdx) for every taskIdx in [0, nTasks); blocks until done
+    void run(int nTasks, const std::function<void(int, int)>& task);
+    
+    // Stop handing out tasks (tasks already running finish normally)
+    void requestStop() { stopRequested = true; }
+    bool isStopRequested() const { return stopRequested; }
+    
+    int getThreadCount() const { return nThreads; }
+    
+private:
+    struct alignas(64) WorkerQueue {
+        std::mutex mtx;
+        std::deque<int> tasks;
+    };
+    
+    int nThreads;
+    std::vector<WorkerQueue> queues;
+    std::atomic<bool> stopRequested{false};
+    
+    bool popLocal(int threadId, int& taskIdx);
+    bool steal(int threadId, int& taskIdx);
+};
+
+#endif
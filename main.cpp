@@ -2,11 +2,245 @@
 #include <vector>
 #include <thread>
 #include <iomanip>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
+#include <algorithm>
 #include "BalancedSet.h"
 #include "CubeSearcherV2.h"
+#include "LayerGenerator.h"
+#include "CubeAssembler.h"
+#include "LayerStore.h"
+#include "LayerIndex.h"
+#include "LayerCache.h"
+#include <chrono>
+#include "SearchOptions.h"
+#include "ResultMerger.h"
+#include "ResultFile.h"
+#include "ShiftCubeSearch.h"
+#include "MeetInMiddleSearch.h"
+#include "CubeVerifier.h"
+
+// Parse a duration such as "3600", "90m" or "12h" into seconds (-1 on error).
+// Durations end up in int fields, so anything above INT_MAX seconds is rejected.
+static long parseDurationSeconds(const std::string& text)
+{
+    if (text.empty()) return -1;
+    long long scale = 1;
+    std::string digits = text;
+    char unit = text.back();
+    if (unit == 's' || unit == 'm' || unit == 'h') {
+        scale = (unit == 'h') ? 3600 : (unit == 'm') ? 60 : 1;
+        digits.pop_back();
+    }
+    if (digits.empty() || digits.find_first_not_of("0123456789") != std::string::npos) return -1;
+    errno = 0;
+    long long value = std::strtoll(digits.c_str(), nullptr, 10);
+    if (errno == ERANGE || value > INT_MAX / scale) return -1;
+    return (long)(value * scale);
+}
+
+// --profile: dump the engine's per-depth counters next to the [STATS] line
+static void writeProfile(const SearchProfile& profile, const SearchStats& stats, const SearchOptions& options)
+{
+    if (options.profilePath.empty()) return;
+    if (profile.writeJson(options.profilePath, stats.engine, stats.seconds)) {
+        std::cout << "[PROFILE] Search profile written to " << options.profilePath << std::endl;
+    } else {
+        std::cout << "[PROFILE] WARNING: Could not write " << options.profilePath << std::endl;
+    }
+}
+
+// [CUBE STRUCTURE] block of a found cube: one line of N rows per layer, value(z, y)
+// giving row y of layer z, with each layer's shift-set base when bases is set
+template <int N, typename Value>
+static void printCubeStructure(Value value, const int* bases)
+{
+    std::cout << "\n[CUBE STRUCTURE]\n" << std::endl;
+    for (int z = 0; z < N; ++z) {
+        std::cout << "Layer " << z;
+        if (bases != nullptr) std::cout << " (base " << bases[z] << ")";
+        std::cout << ": ";
+        for (int y = 0; y < N; ++y) {
+            std::cout << std::setw(N > 8 ? 5 : 3) << value(z, y);
+            if (y < N - 1) std::cout << " ";
+        }
+        std::cout << std::endl;
+    }
+}
+
+template <int N>
+static void printCubeStructure(const std::array<BasicShiftSet<N>, N>& cube)
+{
+    int bases[N];
+    for (int z = 0; z < N; ++z) bases[z] = (int)cube[z].base;
+    printCubeStructure<N>([&cube](int z, int y) { return (int)cube[z].values[y]; }, bases);
+}
+
+static void printCubeStructure(const Cube& cube)
+{
+    printCubeStructure<8>([&cube](int z, int y) { return (int)cube.data[z][y]; }, nullptr);
+}
+
+// Phase 2 for --engine=layers: build every balanced layer, then assemble
+// centrally symmetric cubes from four of them
+static int runLayerEngine(const BalancedSet& bSet, const SearchOptions& options)
+{
+    std::cout << "┌─ PHASE 2: Generate Balanced Layers" << std::endl;
+    LayerCache cache;   // Declared first: the store and index may point into it
+    LayerStore layers;
+    LayerIndex index;
+    const uint64_t rules = LayerGenerator(bSet).rulesFingerprint();
+    auto loadStart = std::chrono::steady_clock::now();
+    if (!options.layerCachePath.empty() && cache.open(options.layerCachePath, rules, layers, index)) {
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+        std::cout << "│  ✓ Mapped " << layers.size() << " layers from " << options.layerCachePath
+                  << " (" << std::fixed << std::setprecision(1) << ms << " ms)" << std::endl;
+    } else {
+        {
+            // The generator's Layer vector is dropped once the packed store is built
+            LayerGenerator generator(bSet);
+            generator.generate(options);
+            layers.assign(generator.getValidLayers());
+        }
+        std::cout << "│  Building lookup index..." << std::endl;
+        index.build(layers);
+        if (!options.layerCachePath.empty()) {
+            if (LayerCache::save(options.layerCachePath, rules, layers, index)) {
+                std::cout << "│  ✓ Saved layer cache to " << options.layerCachePath << std::endl;
+            } else {
+                std::cout << "│  WARNING: Could not write layer cache " << options.layerCachePath << std::endl;
+            }
+        }
+    }
+    std::cout << "└─ Phase 2 Complete" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "┌─ PHASE 3: Assemble Perfect Cubes" << std::endl;
+    std::cout << "│  Method: 4 layers + complements (central symmetry)" << std::endl;
+    std::cout << "│  Threads: " << options.nThreads << " parallel workers" << std::endl;
+    std::cout << "│" << std::endl;
+    CubeAssembler assembler(bSet);
+    assembler.assembleParallel(layers, index, options);
+    std::cout << "└─ Phase 3 Complete" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "[RESULTS] Perfect cubes found: " << assembler.getCubeCount() << std::endl;
+    assembler.getStats().print();
+    writeProfile(assembler.getProfile(), assembler.getStats(), options);
+
+    const Cube* firstCube = assembler.getFirstCube();
+    if (firstCube != nullptr) {
+        printCubeStructure(*firstCube);
+    } else {
+        std::cout << "[STATUS] No perfect cube found" << std::endl;
+    }
+    std::cout << std::string(70, '=') << std::endl;
+
+    return assembler.wasInterrupted() ? 3 : 0;
+}
+
+// Phase 2 for --engine=mitm: join 4-layer halves of filtered shift sets on
+// their complementary Z counts
+static int runMeetEngine(const BalancedSet& bSet, const SearchOptions& options)
+{
+    std::cout << "┌─ PHASE 2: Meet-in-the-Middle Search" << std::endl;
+    std::cout << "│  Method: two 4-layer halves whose Z counts sum to 4 per cell" << std::endl;
+    std::cout << "│  Threads: " << options.nThreads << " parallel workers" << std::endl;
+    std::cout << "│" << std::endl;
+    MeetInMiddleSearch searcher(bSet);
+    searcher.search(options);
+    std::cout << "└─ Phase 2 Complete" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "[RESULTS] Perfect cubes found: " << searcher.getCubeCount() << std::endl;
+    std::cout << "[RESULTS] Ordered layer arrangements: " << searcher.getOrderedCubeCount() << std::endl;
+    searcher.getStats().print();
+    writeProfile(searcher.getProfile(), searcher.getStats(), options);
+
+    const auto* firstCube = searcher.getFirstCube();
+    if (firstCube != nullptr) {
+        printCubeStructure<8>(*firstCube);
+    } else {
+        std::cout << "[STATUS] No perfect cube found" << std::endl;
+    }
+    std::cout << std::string(70, '=') << std::endl;
+
+    return searcher.wasInterrupted() ? 3 : 0;
+}
+
+// --size N (N != 8): the templated shift-set search on an N×N×N cube
+template <int N>
+static int runSizedSearch(const SearchOptions& options)
+{
+    std::cout << "┌─ PHASE 1: Initialize Balanced Numbers (N=" << N << ")" << std::endl;
+    BasicBalancedSet<N> bSet;
+    std::cout << "│  ✓ Total balanced numbers: " << bSet.getAllBalanced().size() << std::endl;
+    std::cout << "│  ✓ Filtered shift sets: " << bSet.getFilteredShiftSets().size() << std::endl;
+    std::cout << "└─ Phase 1 Complete" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "┌─ PHASE 2: Search for Perfect Cubes" << std::endl;
+    ShiftCubeSearch<N> searcher(bSet);
+    searcher.search(options);
+    std::cout << "└─ Phase 2 Complete" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << std::string(70, '=') << std::endl;
+    std::cout << "[RESULTS] Perfect cubes found: " << searcher.getCubeCount() << std::endl;
+    searcher.getStats().print();
+    writeProfile(searcher.getProfile(), searcher.getStats(), options);
+
+    const auto* firstCube = searcher.getFirstCube();
+    if (firstCube != nullptr) {
+        printCubeStructure<N>(*firstCube);
+    } else {
+        std::cout << "[STATUS] No perfect cube found" << std::endl;
+    }
+    std::cout << std::string(70, '=') << std::endl;
+
+    return searcher.wasInterrupted() ? 3 : 0;
+}
 
 int main(int argc, char* argv[])
 {
+    // Subcommand: merge per-shard result files into one verified total
+    if (argc > 1 && std::string(argv[1]) == "merge") {
+        if (argc < 4) {
+            std::cout << "Usage: " << argv[0] << " merge <output.txt> <shard results...>" << std::endl;
+            return 1;
+        }
+        return ResultMerger::merge(argv[2], std::vector<std::string>(argv + 3, argv + argc));
+    }
+
+    // Subcommand: binary solution file -> text result format
+    if (argc > 1 && std::string(argv[1]) == "convert") {
+        if (argc != 4) {
+            std::cout << "Usage: " << argv[0] << " convert <solutions.bin> <output.txt>" << std::endl;
+            return 1;
+        }
+        return ResultFile::convertBinaryToText(argv[2], argv[3]) ? 0 : 1;
+    }
+
+    // Subcommand: re-check every stored cube of a result file on all cores
+    if (argc > 1 && std::string(argv[1]) == "verify") {
+        int threads = (int)std::max(1u, std::thread::hardware_concurrency());
+        char extra;
+        if (argc == 5 && std::string(argv[3]) == "--threads" &&
+            (std::sscanf(argv[4], "%d%c", &threads, &extra) != 1 || threads < 1)) {
+            std::cout << "ERROR: --threads expects a positive number, got " << argv[4] << std::endl;
+            return 1;
+        }
+        if (argc != 3 && !(argc == 5 && std::string(argv[3]) == "--threads")) {
+            std::cout << "Usage: " << argv[0] << " verify <results.txt|solutions.bin> [--threads <n>]" << std::endl;
+            return 1;
+        }
+        return CubeVerifier::verifyFile(argv[2], threads);
+    }
+
     std::cout <<
               "╔════════════════════════════════════════════════════════════╗"
               << std::endl;
@@ -16,34 +250,229 @@ int main(int argc, char* argv[])
               << std::endl;
     std::cout << std::endl;
 
-    std::cout << "GOAL: Find 8x8x8 cubes where ALL lines are balanced numbers" << std::endl;
-    std::cout << "  - Balanced number: 4 bits '1' and 4 bits '0'" << std::endl;
-    std::cout << "  - X-axis: 64 horizontal lines (rows)" << std::endl;
-    std::cout << "  - Y-axis: 64 vertical lines (bit positions in layers)" << std::endl;
-    std::cout << "  - Z-axis: 64 depth lines (columns across layers)" << std::endl;
-    std::cout << "  - Total: 512 bits → 256 zeros, 256 ones" << std::endl;
+    // Check command line arguments
+    SearchOptions options;
+    int requestedThreads = 0;   // 0 = one per CPU core
+    bool seedGiven = false;
+    std::string usage = " [--engine=shift|layers|mitm] [--threads <n>] [--layer-cache <file>]"
+                        " [--branching=index|fail-first]"
+                        " [--size 4|6|8|16] [--portfolio [--seed <n>]]"
+                        " [--progress=human|json|none] [--progress-interval <duration>] [--profile <file.json>]"
+                        " [--find-all] [--combinations [--expand-orderings]] [--symmetric]"
+                        " [--checkpoint <file>] [--checkpoint-interval <duration>]"
+                        " [--resume <file>] [--time-limit <duration>] [--shard <i>/<N>]"
+                        " [--format=text|binary|binary-delta]"
+                        "\n       " + std::string(argv[0]) + " merge <output.txt> <shard results...>"
+                        "\n       " + std::string(argv[0]) + " convert <solutions.bin> <output.txt>"
+                        "\n       " + std::string(argv[0]) + " verify <results.txt|solutions.bin> [--threads <n>]";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if ((arg == "--checkpoint" || arg == "--resume" || arg == "--time-limit" ||
+             arg == "--checkpoint-interval" || arg == "--shard" || arg == "--threads" ||
+             arg == "--layer-cache" || arg == "--profile" || arg == "--progress-interval" ||
+             arg == "--seed" || arg == "--size") && !hasValue) {
+            std::cout << "ERROR: " << arg << " needs a value" << std::endl;
+            return 1;
+        }
+        if (arg == "--engine=shift") {
+            options.engine = Engine::Shift;
+        } else if (arg == "--engine=layers") {
+            options.engine = Engine::Layers;
+        } else if (arg == "--engine=mitm") {
+            options.engine = Engine::Meet;
+        } else if (arg == "--branching=index") {
+            options.branching = Branching::Index;
+        } else if (arg == "--branching=fail-first") {
+            options.branching = Branching::FailFirst;
+        } else if (arg == "--threads") {
+            char extra;
+            if (std::sscanf(argv[++i], "%d%c", &requestedThreads, &extra) != 1 || requestedThreads < 1) {
+                std::cout << "ERROR: --threads expects a positive number, got " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--layer-cache") {
+            options.layerCachePath = argv[++i];
+        } else if (arg == "--size") {
+            std::string size = argv[++i];
+            if (size != "4" && size != "6" && size != "8" && size != "16") {
+                std::cout << "ERROR: --size expects 4, 6, 8 or 16, got " << size << std::endl;
+                return 1;
+            }
+            options.cubeSize = std::stoi(size);
+        } else if (arg == "--portfolio") {
+            options.portfolio = true;
+        } else if (arg == "--seed") {
+            unsigned long long seed = 0;
+            char extra;
+            if (std::sscanf(argv[++i], "%llu%c", &seed, &extra) != 1) {
+                std::cout << "ERROR: --seed expects a number, got " << argv[i] << std::endl;
+                return 1;
+            }
+            options.portfolioSeed = seed;
+            seedGiven = true;
+        } else if (arg == "--progress=human") {
+            options.progressFormat = ProgressFormat::Human;
+        } else if (arg == "--progress=json") {
+            options.progressFormat = ProgressFormat::Json;
+        } else if (arg == "--progress=none") {
+            options.progressFormat = ProgressFormat::None;
+        } else if (arg == "--profile") {
+            options.profilePath = argv[++i];
+        } else if (arg == "--find-all") {
+            options.findOnlyFirst = false;
+        } else if (arg == "--combinations") {
+            options.combinations = true;
+        } else if (arg == "--expand-orderings") {
+            options.expandOrderings = true;
+        } else if (arg == "--symmetric") {
+            options.symmetric = true;
+        } else if (arg == "--format=text") {
+            options.outputFormat = OutputFormat::Text;
+        } else if (arg == "--format=binary") {
+            options.outputFormat = OutputFormat::Binary;
+        } else if (arg == "--format=binary-delta") {
+            options.outputFormat = OutputFormat::BinaryDelta;
+        } else if (arg == "--checkpoint") {
+            options.checkpointPath = argv[++i];
+        } else if (arg == "--resume") {
+            options.resumePath = argv[++i];
+        } else if (arg == "--shard") {
+            int index = -1, count = 0;
+            char extra;
+            if (std::sscanf(argv[++i], "%d/%d%c", &index, &count, &extra) != 2 ||
+                count < 1 || index < 0 || index >= count) {
+                std::cout << "ERROR: --shard expects <i>/<N> with 0 <= i < N, got " << argv[i] << std::endl;
+                return 1;
+            }
+            options.shardIndex = index;
+            options.shardCount = count;
+        } else if (arg == "--time-limit" || arg == "--checkpoint-interval" || arg == "--progress-interval") {
+            long seconds = parseDurationSeconds(argv[++i]);
+            if (seconds <= 0) {
+                std::cout << "ERROR: Invalid duration for " << arg << ": " << argv[i] << std::endl;
+                return 1;
+            }
+            if (arg == "--time-limit") options.timeLimitSeconds = seconds;
+            else if (arg == "--progress-interval") options.progressInterval = (int)seconds;
+            else options.checkpointInterval = (int)seconds;
+        } else {
+            std::cout << "ERROR: Unknown argument: " << arg << std::endl;
+            std::cout << "Usage: " << argv[0] << usage << std::endl;
+            return 1;
+        }
+    }
+    // Meet-in-the-middle cubes are always unordered layer sets
+    if (options.expandOrderings && !options.combinations && options.engine != Engine::Meet) {
+        std::cout << "ERROR: --expand-orderings requires --combinations" << std::endl;
+        return 1;
+    }
+    if (options.engine == Engine::Layers &&
+        (options.combinations || !options.checkpointPath.empty() ||
+         !options.resumePath.empty() || options.shardCount > 1)) {
+        std::cout << "ERROR: --combinations, --checkpoint, --resume and --shard need --engine=shift" << std::endl;
+        return 1;
+    }
+    if (options.engine == Engine::Meet &&
+        (!options.checkpointPath.empty() || !options.resumePath.empty() || options.shardCount > 1)) {
+        std::cout << "ERROR: --checkpoint, --resume and --shard need --engine=shift" << std::endl;
+        return 1;
+    }
+    if (options.cubeSize != 8 &&
+        (options.engine != Engine::Shift || options.portfolio || options.expandOrderings || options.symmetric ||
+         options.outputFormat != OutputFormat::Text || !options.checkpointPath.empty() ||
+         !options.resumePath.empty() || options.shardCount > 1)) {
+        std::cout << "ERROR: --size other than 8 runs the plain shift-set search"
+                  << " (no --engine=layers, --portfolio, --expand-orderings, --symmetric, --format, --checkpoint,"
+                  << " --resume or --shard)" << std::endl;
+        return 1;
+    }
+    if (options.portfolio &&
+        (options.engine != Engine::Shift || !options.findOnlyFirst || !options.checkpointPath.empty() ||
+         !options.resumePath.empty() || options.shardCount > 1)) {
+        std::cout << "ERROR: --portfolio is a find-first mode of --engine=shift"
+                  << " (no --find-all, --checkpoint, --resume or --shard)" << std::endl;
+        return 1;
+    }
+    if (seedGiven && !options.portfolio) {
+        std::cout << "ERROR: --seed needs --portfolio" << std::endl;
+        return 1;
+    }
+    if (options.symmetric && (options.engine != Engine::Shift || options.portfolio)) {
+        std::cout << "ERROR: --symmetric needs --engine=shift (no --portfolio)" << std::endl;
+        return 1;
+    }
+    if (!PBC_PROFILE && !options.profilePath.empty()) {
+        std::cout << "ERROR: --profile is unavailable (built with PBC_PROFILE=OFF)" << std::endl;
+        return 1;
+    }
+    if (options.engine != Engine::Layers && !options.layerCachePath.empty()) {
+        std::cout << "ERROR: --layer-cache needs --engine=layers" << std::endl;
+        return 1;
+    }
+    if (options.engine != Engine::Layers && options.branching != Branching::Index) {
+        std::cout << "ERROR: --branching=fail-first needs --engine=layers" << std::endl;
+        return 1;
+    }
+
+    const int n = options.cubeSize;
+    std::cout << "GOAL: Find " << n << "x" << n << "x" << n << " cubes where ALL lines are balanced numbers" << std::endl;
+    std::cout << "  - Balanced number: " << n / 2 << " bits '1' and " << n / 2 << " bits '0'" << std::endl;
+    std::cout << "  - X-axis: " << n * n << " horizontal lines (rows)" << std::endl;
+    std::cout << "  - Y-axis: " << n * n << " vertical lines (bit positions in layers)" << std::endl;
+    std::cout << "  - Z-axis: " << n * n << " depth lines (columns across layers)" << std::endl;
+    std::cout << "  - Total: " << n * n * n << " bits → " << n * n * n / 2 << " zeros, "
+              << n * n * n / 2 << " ones" << std::endl;
     std::cout << std::endl;
 
-    // Check command line arguments
-    bool findOnlyFirst = true;
-    if (argc > 1 && std::string(argv[1]) == "--find-all") {
-        findOnlyFirst = false;
+    if (!options.findOnlyFirst) {
         std::cout << "[MODE] Finding ALL perfect cubes" << std::endl;
     } else {
         std::cout << "[MODE] Finding FIRST perfect cube (use --find-all for all)" << std::endl;
     }
+    if (options.engine == Engine::Layers) {
+        std::cout << "[MODE] Layer engine: balanced layers + central symmetry" << std::endl;
+    }
+    if (options.branching == Branching::FailFirst) {
+        std::cout << "[MODE] Fail-first branching: most constrained number first" << std::endl;
+    }
+    if (options.engine == Engine::Meet) {
+        std::cout << "[MODE] Meet-in-the-middle: 4-layer halves joined on Z count signatures" << std::endl;
+    }
+    if (options.portfolio) {
+        std::cout << "[MODE] Portfolio: seeded orderings with Luby restarts per thread" << std::endl;
+    }
+    if (options.symmetric) {
+        std::cout << "[MODE] Symmetric: layers 7-4 are the complement sets of layers 0-3" << std::endl;
+    }
+    if (options.combinations) {
+        std::cout << "[MODE] Combination search: each unordered set of 8 layers once" << std::endl;
+    }
+    if (options.shardCount > 1) {
+        std::cout << "[MODE] Shard " << options.shardIndex << " of " << options.shardCount << std::endl;
+    }
     std::cout << std::endl;
 
-    unsigned int nThreads = std::thread::hardware_concurrency();
+    unsigned int nCores = std::thread::hardware_concurrency();
+    if (nCores == 0) nCores = 1;
+    int nThreads = requestedThreads > 0 ? requestedThreads : (int)nCores;
+    options.nThreads = nThreads;
     std::cout <<
               "════════════════════════════════════════════════════════════"
               << std::endl;
-    std::cout << "[SYSTEM] Detected " << nThreads << " CPU cores" << std::endl;
+    std::cout << "[SYSTEM] Detected " << nCores << " CPU cores" << std::endl;
     std::cout <<
               "════════════════════════════════════════════════════════════"
               << std::endl;
     std::cout << std::endl;
 
+    switch (options.cubeSize) {
+        case 4: return runSizedSearch<4>(options);
+        case 6: return runSizedSearch<6>(options);
+        case 16: return runSizedSearch<16>(options);
+        default: break;
+    }
+
     // Phase 1: Initialize balanced number set and shift sets
     std::cout << "┌─ PHASE 1: Initialize Balanced Numbers" << std::endl;
     BalancedSet bSet;
@@ -59,6 +488,13 @@ int main(int argc, char* argv[])
         return 1;
     }
 
+    if (options.engine == Engine::Layers) {
+        return runLayerEngine(bSet, options);
+    }
+    if (options.engine == Engine::Meet) {
+        return runMeetEngine(bSet, options);
+    }
+
     // Phase 2: Search for perfect cubes
     std::cout << "┌─ PHASE 2: Search for Perfect Cubes" << std::endl;
     std::cout << "│  Method: Shift rotation + validated permutation search" << std::endl;
@@ -67,7 +503,7 @@ int main(int argc, char* argv[])
     std::cout << "│" << std::endl;
 
     CubeSearcherV2 searcher(bSet);
-    searcher.search(nThreads, findOnlyFirst);
+    searcher.search(options);
 
     std::cout << std::endl;
     std::cout << "└─ Phase 2 Complete" << std::endl;
@@ -78,6 +514,11 @@ int main(int argc, char* argv[])
               << std::endl;
     std::cout << "[FINISHED] Search complete!" << std::endl;
     std::cout << "[RESULTS] Perfect cubes found: " << searcher.getCubeCount() << std::endl;
+    if (options.combinations) {
+        std::cout << "[RESULTS] Ordered layer arrangements: " << searcher.getOrderedCubeCount() << std::endl;
+    }
+    searcher.getStats().print();
+    writeProfile(searcher.getProfile(), searcher.getStats(), options);
     
     // Validate and display the first found cube if any
     const auto* firstCube = searcher.getFirstCube();
@@ -86,15 +527,7 @@ int main(int argc, char* argv[])
         std::cout << "✓✓✓ FIRST PERFECT CUBE DISCOVERED! ✓✓✓" << std::endl;
         std::cout << std::string(70, '=') << std::endl;
         
-        std::cout << "\n[CUBE STRUCTURE]\n" << std::endl;
-        for (int i = 0; i < 8; ++i) {
-            std::cout << "Layer " << i << " (base " << (int)(*firstCube)[i].base << "): ";
-            for (int j = 0; j < 8; ++j) {
-                std::cout << std::setw(3) << (int)(*firstCube)[i].values[j];
-                if (j < 7) std::cout << " ";
-            }
-            std::cout << std::endl;
-        }
+        printCubeStructure<8>(*firstCube);
         
         // Validate
         std::cout << "\n[VALIDATION]" << std::endl;
@@ -111,5 +544,13 @@ int main(int argc, char* argv[])
     
     std::cout << std::string(70, '=') << std::endl;
 
+    // Distinct exit code so batch scripts know to requeue with --resume
+    if (searcher.wasInterrupted()) {
+        if (!options.portfolio) {
+            std::cout << "[CHECKPOINT] Run stopped by --time-limit; resume from the checkpoint" << std::endl;
+        }
+        return 3;
+    }
+
     return 0;
 }